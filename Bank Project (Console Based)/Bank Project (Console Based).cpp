@@ -4,6 +4,56 @@
 #include <fstream>
 #include <iomanip>
 #include <cctype>
+#include <unordered_map>
+#include <map>
+#include <algorithm>
+#include <string_view>
+#include <charconv>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <thread>
+#include <functional>
+#include <limits>
+#include <cstdio>
+#include <cerrno>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <condition_variable>
+#include <chrono>
+#include <random>
+#include <ctime>
+#include <filesystem>
+#include <new>
+#include <cstdlib>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BANK_USE_SSE2
+#endif
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <afunix.h>
+#include <windows.h>
+#pragma comment(lib, "Ws2_32.lib")
+#ifndef IO_REPARSE_TAG_AF_UNIX
+#define IO_REPARSE_TAG_AF_UNIX 0x80000023L
+#endif
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#endif
 
 using namespace std;
 
@@ -11,22 +61,125 @@ using namespace std;
 const string ClientFileName = "ClientDataFile.txt";
 const string UserFileName = "Users.txt";
 
+/// Binary snapshot of the clients, used instead of ClientFileName when UseBinarySnapshot is set.
+const string ClientBinaryFileName = "ClientDataFile.bin";
+
+/// Journal of balance changes applied on top of ClientFileName.
+const string ClientJournalFileName = "ClientJournal.txt";
+
+/// Journal applied on top of ClientBinaryFileName, kept apart so text
+/// and binary runs never replay each other's records.
+const string ClientBinaryJournalFileName = "ClientBinaryJournal.txt";
+
+/// Every balance change of every account, in the order it was made.
+const string ClientHistoryFileName = "ClientHistory.txt";
+
+/// Journal of user deletes applied on top of UserFileName.
+const string UserJournalFileName = "UserJournal.txt";
+
+/// Number of journal records after which the journal is folded back into ClientFileName.
+const int JournalCompactionThreshold = 1000;
+
+/// History entries of an account are indexed in blocks of this many entries.
+const size_t HistoryBlockSize = 64;
+
+/// Most worker threads per core that --threads can ask for.
+const unsigned MaxWorkerThreadsPerCore = 4;
+
+/// Most history entries shown by one query.
+const short MaxHistoryEntries = 1000;
+
+/// End of day defaults: how many largest balances are reported, and
+/// after how many days without a change an account counts as dormant.
+/// Set with --top and --dormant-days.
+const size_t DefaultEodTopCount = 10;
+const int DefaultEodDormantDays = 90;
+
+/// Benchmark sizes: records of the default data sets, calls of the whole
+/// data set operations, and calls of the single record operations.
+/// Balance changes wait for the disk, so they get fewer calls.
+const vector <size_t> DefaultBenchRecordCounts = { 10000, 1000000, 10000000 };
+const size_t BenchRepetitions = 3;
+const size_t BenchSampleOperations = 100000;
+const size_t BenchBalanceOperations = 400;
+
+/// Deleted clients and users stay in memory as tombstones until the
+/// compactor rewrites their file, once they are GarbageCompactionPercent
+/// of the rows or GarbageCompactionMaxRows rows.
+const int GarbageCompactionPercent = 25;
+const size_t GarbageCompactionMaxRows = 10000;
+
+/// Journal records are written in batches: a batch is written once it holds
+/// GroupCommitMaxRecords records or GroupCommitWindowMilliseconds after its
+/// first record, whichever comes first. Set with --commit-batch and --commit-window.
+int GroupCommitMaxRecords = 256;
+int GroupCommitWindowMilliseconds = 2;
+
+/// Rounds of PBKDF2-HMAC-SHA256 for new password hashes, the work factor
+/// that makes guessing passwords slow. Set with --hash-iterations.
+int PasswordHashIterations = 20000;
+
+/// Start of a hashed password in the users file: $pbkdf2-sha256$Iterations$Salt$Hash.
+const string PasswordHashPrefix = "$pbkdf2-sha256$";
+
+/// Seconds a successful login is remembered, logging in again within
+/// them skips the password hash.
+const int VerifiedSessionSeconds = 300;
+
+/// Returned by ReadMenuOption when the input ended.
+const short EndOfInputOption = -2;
+
 /// Enum for main menu options
 enum enMainMenuOption { enShowClientList = 1, enAddNewClient = 2, enDeleteClient = 3, enUpdateClient = 4, enFindClient = 5, enTransactions = 6, enManageUsers = 7, Logout = 8 };
 
 /// Enum for transactions menu options
-enum enTransactionsMenuOptions { enDeposit = 1, enWithdraw = 2, enTotalBalances = 3, enMainMenuTransactions = 4 };
+enum enTransactionsMenuOptions { enDeposit = 1, enWithdraw = 2, enTransfer = 3, enAccountHistory = 4, enTotalBalances = 5, enMainMenuTransactions = 6 };
 
 /// Enum for Manage user menu options
 enum enManageUserMenuOptions { enShowUsersList = 1, enAddNewUser = 2, enDeleteUser = 3, enUpdateUser = 4, enFindUser = 5, enMainMenuUsers = 6 };
 
 /// Enum for Main Menu permissions
-enum enMainMenuPermissions { eAll = -1, pListClients = 1, pAddNewClients = 2, pDeleteClient = 4, pUpdateClient = 8, pFindClient = 16, pTransactions = 32, pManageUsers = 64 };
+enum enMainMenuPermissions { eAll = -1, pNone = 0, pListClients = 1, pAddNewClients = 2, pDeleteClient = 4, pUpdateClient = 8, pFindClient = 16, pTransactions = 32, pManageUsers = 64 };
+
+/// Every permission bit. A stored mask of eAll means all of them.
+constexpr int AllPermissions = pListClients | pAddNewClients | pDeleteClient | pUpdateClient | pFindClient | pTransactions | pManageUsers;
+
+/// States of the console session, one per menu.
+enum enMenuState { enLoginState, enMainMenuState, enTransactionsMenuState, enManageUsersMenuState, enExitState };
+
+/// Result of an operation on the clients or users, shared by the console and the service.
+enum enStoreResult { enStoreDone, enStoreNotFound, enStoreAlreadyExists, enStoreInsufficientFunds, enStoreInvalidAmount, enStoreNotAllowed };
+
+/// Number of locks the client accounts are spread over.
+const size_t AccountLockStripes = 64;
+
+/// Ways to find a client on the find client screen.
+enum enFindClientMode { enFindByAccountNumber = 1, enFindByNamePrefix = 2, enFindByNameContains = 3, enFindByPhoneNumber = 4 };
+
+/// Kinds of client name search.
+enum enNameSearchMode { enNamePrefix, enNameContains };
+
+/// Most clients a name search returns.
+const size_t MaxSearchResults = 100;
+
+/// Orders the client list can be shown in.
+enum enClientListSortKey { enSortByFileOrder = 1, enSortByAccountNumber = 2, enSortByName = 3, enSortByBalance = 4 };
+
+/// Rows per page of the client list.
+const size_t DefaultClientListPageSize = 20;
+const short MaxClientListPageSize = 1000;
+
+/// Longest request line the service accepts.
+const size_t MaxServiceRequestLength = 64 * 1024;
+
+/// Amount of money in cents. Balances and amounts are whole cents so
+/// sums are exact and do not depend on the order they are added in.
+typedef int64_t Money;
 
 /// Represents a single clients data.
 struct stClient {
 	string AccountNumber, PinCode, FullName, PhoneNumber;
-	double AccountBalance;
+	Money AccountBalance = 0;
 	bool MarkForDelete = false;
 };
 
@@ -38,1537 +191,6766 @@ struct stUser {
 	bool MarkForDelete = false;
 };
 
+/// A named set of permissions offered when a user is created or updated.
+struct stRole {
+	const char* Name;
+	int Permissions;
+};
 
-stUser CurrentUser;
+constexpr stRole Roles[] = {
+	{ "Teller", pFindClient | pTransactions },
+	{ "Clerk", pListClients | pAddNewClients | pUpdateClient | pFindClient },
+	{ "Manager", pListClients | pAddNewClients | pDeleteClient | pUpdateClient | pFindClient | pTransactions },
+	{ "Auditor", pListClients | pFindClient } };
+
+constexpr short RoleCount = sizeof(Roles) / sizeof(Roles[0]);
+
+/// A logged in user with the rights computed once at login, so each
+/// permission check is a single AND.
+struct stSession {
+	stUser User;
+	int Rights = pNone;
+	bool LoggedIn = false;
+};
+
+/// Holds every user in memory for the whole program run.
+/// UserNameIndex maps a username to its position in vUsers.
+/// DeletedUsers counts the users marked for delete still in vUsers.
+/// LinesPending is set while the users file is mapped but not parsed yet.
+struct stUsersRepository {
+	vector <stUser> vUsers;
+	unordered_map <string, size_t> UserNameIndex;
+	size_t DeletedUsers = 0;
+	bool LinesPending = false;
+};
+
+/// A recent successful login: the stored password it was checked against
+/// and a fast keyed digest of the password that was given.
+struct stVerifiedSession {
+	string StoredPassword;
+	string PasswordDigest;
+	chrono::steady_clock::time_point Expires;
+};
+
+/// State of a SHA-256 computation.
+struct stSha256 {
+	uint32_t State[8];
+	uint64_t Length = 0;
+	uint8_t Buffer[64];
+	size_t BufferSize = 0;
+};
+
+/// Upper limits (exclusive) of the balance ranges used by balance histograms.
+/// The last range holds every balance from the last limit upwards.
+const Money BalanceBucketLimits[] = { 0, 100 * 100, 1000 * 100, 10000 * 100, 100000 * 100, 1000000 * 100 };
+const int BalanceBucketCount = sizeof(BalanceBucketLimits) / sizeof(BalanceBucketLimits[0]) + 1;
+
+/// Column-wise copy of the clients used by reporting scans.
+/// Row i matches ClientsRepository.vClients[i], so balances can be summed
+/// without dragging the text fields through the cache. Names are interned
+/// once in vNames and referenced by id. Rows of deleted clients keep their
+/// place with a zero balance and IsActive set to 0.
+struct stClientsColumns {
+	vector <Money> vBalances;
+	vector <uint8_t> vIsActive;
+	vector <uint32_t> vNameIds;
+	vector <string> vNames;
+	unordered_map <string, uint32_t> NameIds;
+};
+
+/// Secondary index on the client names, keys are lowercase.
+/// Sorted serves prefix searches. Trigrams maps every three characters
+/// of a name to the rows holding them and serves contains searches.
+/// Each trigram list holds a row once, in row order, while its current
+/// name has that trigram.
+struct stClientNameIndex {
+	multimap <string, size_t> Sorted;
+	unordered_map <uint32_t, vector <uint32_t>> Trigrams;
+};
+
+/// Reverse index from a normalized phone number to the rows of the
+/// active clients holding it. vKeys keeps the key each row is indexed
+/// under, so a row can be taken out after its phone number changed.
+struct stClientPhoneIndex {
+	unordered_map <string, vector <size_t>> Positions;
+	vector <string> vKeys;
+};
+
+/// Result of a scan over the balance column.
+struct stBalanceSummary {
+	size_t ClientCount = 0;
+	Money TotalBalances = 0;
+	Money MinBalance = 0;
+	Money MaxBalance = 0;
+	size_t vBuckets[BalanceBucketCount] = {};
+};
+
+/// Aggregates of the active balances, kept up to date by every change
+/// so the totals are read without a scan. Balance changes of different
+/// accounts update them at the same time, so every field is atomic.
+/// Min and max only widen on the fly: when the balance holding one of
+/// them moves inward, MinMaxStale is set and they are recounted on the next read.
+struct stRunningTotals {
+	atomic <size_t> ClientCount{ 0 };
+	atomic <Money> TotalBalances{ 0 };
+	atomic <Money> MinBalance{ 0 };
+	atomic <Money> MaxBalance{ 0 };
+	atomic <bool> MinMaxStale{ false };
+	atomic <size_t> vBuckets[BalanceBucketCount]{};
+};
+
+/// Holds every client in memory for the whole program run.
+/// AccountNumberIndex maps an account number to its position in vClients.
+/// DeletedClients counts the clients marked for delete still in vClients.
+struct stClientsRepository {
+	vector <stClient> vClients;
+	unordered_map <string, size_t> AccountNumberIndex;
+	stClientsColumns Columns;
+	stClientNameIndex NameIndex;
+	stClientPhoneIndex PhoneIndex;
+	stRunningTotals Totals;
+	int JournalRecords = 0;
+	size_t DeletedClients = 0;
+};
+
+
+/// Header at the start of a binary clients snapshot.
+/// Checksum is the FNV-1a hash of everything after the header.
+struct stBinarySnapshotHeader {
+	char Magic[4];
+	uint32_t Version;
+	uint64_t RecordCount;
+	uint64_t StringTableSize;
+	uint64_t Checksum;
+};
+
+/// Fixed width client record of a binary snapshot.
+/// The four text fields are stored one after the other in the string
+/// table, starting at StringsOffset, in the order of stClient.
+/// AccountBalance holds cents since version 2, version 1 stored a double.
+struct stBinaryClientRecord {
+	uint64_t StringsOffset;
+	uint32_t FieldLength[4];
+	int64_t AccountBalance;
+};
+
+static_assert(sizeof(stBinarySnapshotHeader) == 32, "Binary snapshot header must stay 32 bytes");
+static_assert(sizeof(stBinaryClientRecord) == 32, "Binary client record must stay 32 bytes");
+
+const char BinarySnapshotMagic[4] = { 'B', 'N', 'K', 'S' };
+const uint32_t BinarySnapshotVersion = 2;
+
+/// Type of a batch posting.
+enum enPostingType { enPostingDeposit = 'D', enPostingWithdraw = 'W' };
+
+/// A single deposit or withdraw read from a posting file.
+/// AccountNumber and Line point into the posting file buffer.
+struct stPosting {
+	string_view AccountNumber;
+	char Type = enPostingDeposit;
+	Money Amount = 0;
+	size_t LineNumber = 0;
+	string_view Line;
+};
+
+/// A posting that could not be applied, with the reason why.
+struct stRejectedPosting {
+	size_t LineNumber = 0;
+	string_view Line;
+	string Reason;
+};
+
+/// Postings parsed from one chunk of a posting file, split by the
+/// shard (worker) that owns their account. Line numbers are counted
+/// from the start of the chunk until FirstLineNumber is known.
+struct stPostingChunk {
+	string_view Data;
+	size_t FirstLineNumber = 1;
+	vector <vector <stPosting>> vShards;
+	vector <stRejectedPosting> vRejects;
+};
+
+/// End of day reports computed over one range of the client table.
+/// vTopBalances holds the largest balances with their rows, vDormantRows
+/// the rows without a recent change.
+struct stEodAccumulator {
+	stBalanceSummary Summary;
+	Money vBucketTotals[BalanceBucketCount] = {};
+	vector <pair <Money, uint32_t>> vTopBalances;
+	vector <uint32_t> vDormantRows;
+};
+
+/// Result of one benchmark: the time of every call, in microseconds,
+/// and the heap allocations all the calls made.
+struct stBenchResult {
+	string Name;
+	uint64_t ItemsPerOperation = 1;
+	vector <double> vMicroseconds;
+	uint64_t Allocations = 0;
+};
+
+/// One option of a menu: the permission it needs, the screen it runs,
+/// the pause shown after it (nullptr for none) and the session state to move to.
+struct stMenuAction {
+	short Option;
+	enMainMenuPermissions Permission;
+	void (*Screen)();
+	void (*GoBack)();
+	enMenuState NextState;
+};
+
+/// A menu of the console session, its options are numbered from 1.
+struct stMenu {
+	void (*ShowScreen)();
+	const stMenuAction* Actions;
+	short OptionCount;
+};
+
+/// A request of the service mode: its name, the permission it needs
+/// and the function that serves it with the fields after the name.
+struct stServiceCommand {
+	string_view Name;
+	enMainMenuPermissions Permission;
+	string (*Serve)(string_view Arguments);
+};
+
+/// A whole file mapped read-only into memory.
+struct stMappedFile {
+	const char* Data = nullptr;
+	size_t Size = 0;
+#ifdef _WIN32
+	HANDLE FileHandle = INVALID_HANDLE_VALUE;
+	HANDLE MappingHandle = NULL;
+#else
+	int FileDescriptor = -1;
+#endif
+};
+
+/// Lines of a mapped file, turned into records only when they are touched.
+/// vLineNumbers holds the file line number of each entry of vLines.
+struct stLazyRecordsFile {
+	stMappedFile File;
+	vector <string_view> vLines;
+	vector <size_t> vLineNumbers;
+};
+
+/// Journal records waiting to be written by the group commit flusher.
+/// Batches are numbered, a caller is acknowledged once DurableBatch
+/// reaches the batch its record went into.
+struct stGroupCommit {
+	mutex Mutex;
+	condition_variable BatchReady;
+	condition_variable BatchDurable;
+	condition_variable FlusherStopped;
+	string PendingRecords;
+	string PendingHistory;
+	int PendingCount = 0;
+	chrono::steady_clock::time_point BatchOpened;
+	uint64_t OpenBatch = 1;
+	uint64_t DurableBatch = 0;
+	bool FlusherRunning = false;
+	bool Stopping = false;
+};
+
+/// One balance change of an account. Type is D for a deposit, W for a
+/// withdraw and T for a transfer. Amount is negative when money left
+/// the account, Balance is the balance right after the change.
+struct stHistoryEntry {
+	string AccountNumber;
+	int64_t Time = 0;
+	char Type = 'D';
+	Money Amount = 0;
+	Money Balance = 0;
+	string Operator;
+};
 
-void ShowMainMenuScreen();
-void ShowTransactionsMenuScreen();
-void Login();
-void ShowManageUsersMenuScreen();
-void ShowAccesDeniedMessage();
-void GoBackToMainMenu();
+/// Consecutive history entries of one account: where their lines start
+/// in ClientHistoryFileName and the time span they cover.
+struct stHistoryBlock {
+	int64_t FirstTime = 0;
+	int64_t LastTime = 0;
+	vector <uint64_t> vOffsets;
+};
+
+/// Block index of the history file: the blocks of every account, oldest
+/// first, and the size the file will have once the queued entries are written.
+struct stClientHistory {
+	unordered_map <string, vector <stHistoryBlock>> Blocks;
+	uint64_t FileSize = 0;
+};
+
+/// State of the background compactor, started on demand. Requested is
+/// set when more garbage shows up while it is running, Stopped is
+/// signaled when it stops running.
+struct stCompactor {
+	mutex Mutex;
+	condition_variable Stopped;
+	bool Running = false;
+	bool Requested = false;
+};
+
+/// Connected or listening socket of the service mode.
+#ifdef _WIN32
+typedef SOCKET SocketHandle;
+const SocketHandle InvalidSocket = INVALID_SOCKET;
+#else
+typedef int SocketHandle;
+const SocketHandle InvalidSocket = -1;
+#endif
+
+stUser CurrentUser;
+int CurrentRights = pNone;
+stClientsRepository ClientsRepository;
+stUsersRepository UsersRepository;
+stLazyRecordsFile PendingUsersFile;
+unordered_map <string, stVerifiedSession> VerifiedSessions;
+string SessionDigestKey;
+bool UseBinarySnapshot = false;
 
 /**
- * @brief Reads deposit amount from user.
- * @return The deposit amount.
+ * @brief Gets the journal of the clients file in use.
+ * @return ClientBinaryJournalFileName when UseBinarySnapshot is set, ClientJournalFileName otherwise.
  */
-int ReadDepositAmount() {
-	int DepositAmount = 0;
-	cout << "\nPlease enter Deposit Amount? ";
-	cin >> DepositAmount;
+const string& GetClientJournalFileName() {
 
-	return DepositAmount;
+	return UseBinarySnapshot ? ClientBinaryJournalFileName : ClientJournalFileName;
 }
 
-/**
- * @brief Reads withdraw amount from user.
- * @return The withdraw amount.
- */
-double ReadWithdrawAmount() {
-	double WithdrawAmount = 0;
-	cout << "\nPlease enter Withdraw Amount? ";
-	cin >> WithdrawAmount;
+/// Guards the layout of the clients repository. Balance changes share it,
+/// adding, updating, deleting and saving clients take it alone.
+shared_mutex ClientsMutex;
+
+/// Per-account locks: balance changes of one account run one at a time,
+/// while accounts on other stripes change in parallel.
+mutex AccountLocks[AccountLockStripes];
+
+/// Serializes writes to the clients journal file.
+mutex JournalMutex;
+
+stGroupCommit GroupCommit;
+
+stCompactor Compactor;
+
+/// Guarded by GroupCommit.Mutex, history entries are queued along with the journal records.
+stClientHistory ClientHistory;
+
+/// User recorded as the operator of the balance changes made by this
+/// thread: the console user or the user of the service session.
+thread_local string OperatorName;
+
+/// Guards the users repository and the verified sessions.
+mutex UsersMutex;
+
+/// Results of the benchmarked calls are added here, so the compiler
+/// cannot drop a call whose result is not otherwise used.
+volatile int64_t BenchSink = 0;
+
+#ifdef BANK_BENCHMARK
+
+/// Heap allocations made by this thread, counted by the replaced
+/// operator new so the benchmarks can report them. Only builds with
+/// BANK_BENCHMARK defined replace the allocator.
+const bool CountAllocations = true;
+thread_local uint64_t AllocationCount = 0;
 
-	return WithdrawAmount;
+// GCC inlines the replaced operator delete into its callers and then
+// warns that free gets a pointer from operator new, so it is kept out of line.
+#ifdef __GNUC__
+#define NOINLINE __attribute__((noinline))
+#else
+#define NOINLINE
+#endif
+
+void* operator new(size_t Size) {
+
+	AllocationCount++;
+
+	if (void* Block = malloc((Size == 0) ? 1 : Size))
+		return Block;
+
+	throw bad_alloc();
+}
+
+NOINLINE void operator delete(void* Block) noexcept {
+	free(Block);
+}
+
+NOINLINE void operator delete(void* Block, size_t) noexcept {
+	free(Block);
 }
 
+#else
+
+/// Other builds keep the default allocator and report no allocation counts.
+const bool CountAllocations = false;
+const uint64_t AllocationCount = 0;
+
+#endif
+
 /**
- * @brief Splits a string into substrings by a given delimiter.
- * @param Text Input string.
- * @param delim Delimiter string.
- * @return Vector of substrings.
+ * @brief Parses an amount written with up to two decimals, like "150" or "-20.5".
+ *
+ * Extra decimals, as in files saved with six decimals, are rounded
+ * half away from zero to the nearest cent.
+ *
+ * @param Text Amount text.
+ * @param Amount Output amount in cents.
+ * @return True if the text is a valid amount, false otherwise.
  */
-vector <string> SplitString(string Text, string delim) {
+bool ParseMoney(string_view Text, Money& Amount) {
 
-	vector <string> vString{};
-	short pos = 0;
-	string sWord;
+	bool Negative = false;
 
-	while ((pos = Text.find(delim)) != std::string::npos) {
-		sWord = Text.substr(0, pos);
-		if (sWord != "")
-			vString.push_back(sWord);
-		Text.erase(0, pos + delim.length());
+	if (!Text.empty() && Text[0] == '-') {
+		Negative = true;
+		Text.remove_prefix(1);
 	}
-	if (Text != "")
-		vString.push_back(Text);
 
-	return vString;
-}
+	size_t Dot = Text.find('.');
+	string_view Units = Text.substr(0, Dot);
+	string_view Fraction = (Dot == string_view::npos) ? string_view() : Text.substr(Dot + 1);
 
-/**
- * @brief Converts a line from the file into a stClient record.
- * @param Line Raw line from file.
- * @param Seperator Delimiter between fields.
- * @return Parsed stClient record.
- */
-stClient ConvertClientsLineDataToRecord(string Line, string Seperator = "#//#") {
+	if (Units.empty() && Fraction.empty())
+		return false;
 
-	stClient ClientData;
-	vector <string> vClient;
-	vClient = SplitString(Line, Seperator);
+	for (char C : Units)
+		if (!isdigit((unsigned char)C))
+			return false;
+	for (char C : Fraction)
+		if (!isdigit((unsigned char)C))
+			return false;
 
-	ClientData.AccountNumber = vClient[0];
-	ClientData.PinCode = vClient[1];
-	ClientData.FullName = vClient[2];
-	ClientData.PhoneNumber = vClient[3];
-	ClientData.AccountBalance = stod(vClient[4]);
+	Money Whole = 0;
+	if (!Units.empty() && from_chars(Units.data(), Units.data() + Units.size(), Whole).ec != errc())
+		return false;
 
-	return ClientData;
+	Money Cents = 0;
+	for (size_t i = 0; i < 2; i++)
+		Cents = Cents * 10 + ((i < Fraction.size()) ? Fraction[i] - '0' : 0);
+	if (Fraction.size() > 2 && Fraction[2] >= '5')
+		Cents++;
+
+	if (Whole > (INT64_MAX - 100) / 100)
+		return false;
+
+	Amount = Whole * 100 + Cents;
+	if (Negative)
+		Amount = -Amount;
+
+	return true;
 }
 
 /**
- * @brief Converts a line from the file into a stUser record.
- * @param Line Raw line from file.
- * @param Seperator Delimiter between fields.
- * @return Parsed stUser record.
+ * @brief Formats an amount in cents with two decimals, like "150.00".
+ * @param Amount Amount in cents.
+ * @return Formatted amount.
  */
-stUser ConvertUsersLineDataToRecord(string Line, string Seperator = "#//#") {
+string FormatMoney(Money Amount) {
 
-	stUser User;
-	vector <string> vUser;
+	uint64_t Magnitude = (Amount < 0) ? 0 - (uint64_t)Amount : (uint64_t)Amount;
+	string Cents = to_string(Magnitude % 100);
 
-	vUser = SplitString(Line, Seperator);
+	return ((Amount < 0) ? "-" : "") + to_string(Magnitude / 100) + "." + ((Cents.size() == 1) ? "0" : "") + Cents;
+}
 
-	User.UserName = vUser[0];
-	User.Password = vUser[1];
-	User.Permissions = stoi(vUser[2]);
+/**
+ * @brief Reads an amount from user, asking again until it is valid.
+ * @return The amount in cents, 0 if the input ended.
+ */
+Money ReadMoney() {
+	string Text;
+	Money Amount = 0;
+
+	cin >> Text;
+	while (cin && !ParseMoney(Text, Amount)) {
+		cout << "Invalid amount, please enter an amount like 150 or 150.25? ";
+		cin >> Text;
+	}
 
-	return User;
+	return cin ? Amount : 0;
 }
 
 /**
- * @brief Loads all clients from file.
- * @param FileName The file to read from.
- * @return Vector of clients.
+ * @brief Reads a positive amount from user, asking again until it is valid.
+ * @return The amount in cents, 0 if the input ended.
  */
-vector <stClient> LoadClientsDataFromFile(string FileName) {
+Money ReadPositiveMoney() {
+	Money Amount = ReadMoney();
 
-	vector <stClient> vFileContent;
-	fstream MyFile;
+	while (cin && Amount <= 0) {
+		cout << "Amount must be greater than zero, please enter it again? ";
+		Amount = ReadMoney();
+	}
 
-	MyFile.open(FileName, ios::in);
-	if (MyFile.is_open()) {
-		string Line;
-		stClient Client;
+	return Amount;
+}
 
-		while (getline(MyFile, Line)) {
-			Client = ConvertClientsLineDataToRecord(Line);
-			vFileContent.push_back(Client);
-		}
+/**
+ * @brief Reads deposit amount from user.
+ * @return The deposit amount in cents.
+ */
+Money ReadDepositAmount() {
+	cout << "\nPlease enter Deposit Amount? ";
 
-		MyFile.close();
-	}
+	return ReadPositiveMoney();
+}
 
-	return vFileContent;
+/**
+ * @brief Reads withdraw amount from user.
+ * @return The withdraw amount in cents.
+ */
+Money ReadWithdrawAmount() {
+	cout << "\nPlease enter Withdraw Amount? ";
+
+	return ReadPositiveMoney();
 }
 
 /**
- * @brief Loads all Users from file.
- * @param FileName The file to read from.
- * @return Vector of users.
+ * @brief Splits a line into fields by a given delimiter without copying.
+ *
+ * Fields are returned as views into Line, so Line must outlive them.
+ * Empty fields are kept so every field stays at its position.
+ *
+ * @param Line Input line.
+ * @param delim Delimiter string.
+ * @param Fields Output array of fields.
+ * @param MaxFields Size of the Fields array.
+ * @return Number of fields found, MaxFields + 1 if the line has more fields.
  */
-vector <stUser> LoadUsersDataFromFile(string FileName) {
+size_t SplitLine(string_view Line, string_view delim, string_view Fields[], size_t MaxFields) {
 
-	vector <stUser> vFileContent;
+	size_t Count = 0;
+	size_t pos = 0;
 
-	fstream MyFile;
-	MyFile.open(FileName, ios::in);
+	while (true) {
+		size_t Next = Line.find(delim, pos);
 
-	if (MyFile.is_open()) {
-		string Line;
-		stUser User;
+		if (Count == MaxFields)
+			return MaxFields + 1;
 
-		while (getline(MyFile, Line)) {
-			User = ConvertUsersLineDataToRecord(Line);
-			vFileContent.push_back(User);
+		if (Next == string_view::npos) {
+			Fields[Count++] = Line.substr(pos);
+			return Count;
 		}
 
-		MyFile.close();
+		Fields[Count++] = Line.substr(pos, Next - pos);
+		pos = Next + delim.length();
 	}
-
-	return vFileContent;
 }
 
 /**
- * @brief Converts client record into a file line.
- * @param ClientData Client data.
- * @param Seprator Field separator.
- * @return String line for file storage.
+ * @brief Parses a whole field as a number.
+ * @param Field Field text.
+ * @param Value Output number.
+ * @return True if the field is a valid number, false otherwise.
  */
-string ConvertRecordToLine(stClient& ClientData, string Seprator) {
-
-	string stClientRecord = "";
+template <typename T>
+bool ParseNumberField(string_view Field, T& Value) {
 
-	stClientRecord += ClientData.AccountNumber + Seprator;
-	stClientRecord += ClientData.PinCode + Seprator;
-	stClientRecord += ClientData.FullName + Seprator;
-	stClientRecord += ClientData.PhoneNumber + Seprator;
-	stClientRecord += to_string(ClientData.AccountBalance);
+	const char* End = Field.data() + Field.size();
+	from_chars_result Result = from_chars(Field.data(), End, Value);
 
-	return stClientRecord;
+	return Result.ec == errc() && Result.ptr == End;
 }
 
 /**
- * @brief Converts user record into a file line.
- * @param User user data.
- * @param Seprator Field separator.
- * @return String line for file storage.
+ * @brief Converts a line from the file into a stClient record.
+ * @param Line Raw line from file.
+ * @param ClientData Output client record.
+ * @param Seperator Delimiter between fields.
+ * @return True if the line is a valid client record, false otherwise.
  */
-string ConvertRecordToLine(stUser& User, string Seprator) {
+bool ConvertClientsLineDataToRecord(string_view Line, stClient& ClientData, string_view Seperator = "#//#") {
 
-	string stUserRecord = "";
+	string_view vClient[5];
 
-	stUserRecord += User.UserName + Seprator;
-	stUserRecord += User.Password + Seprator;
-	stUserRecord += to_string(User.Permissions);
+	if (SplitLine(Line, Seperator, vClient, 5) != 5 || vClient[0].empty())
+		return false;
 
-	return stUserRecord;
+	if (!ParseMoney(vClient[4], ClientData.AccountBalance))
+		return false;
+
+	ClientData.AccountNumber.assign(vClient[0]);
+	ClientData.PinCode.assign(vClient[1]);
+	ClientData.FullName.assign(vClient[2]);
+	ClientData.PhoneNumber.assign(vClient[3]);
+	ClientData.MarkForDelete = false;
+
+	return true;
 }
 
 /**
- * @brief Checks if the currently logged-in user has access to a given permission.
- *
- * @param Permission The required permission to check (from enMainMenuPermissions).
- * @return true  If the current user has the required permission.
- * @return false If the current user does not have the required permission.
+ * @brief Converts a line from the file into a stUser record.
+ * @param Line Raw line from file.
+ * @param User Output user record.
+ * @param Seperator Delimiter between fields.
+ * @return True if the line is a valid user record, false otherwise.
  */
-bool CheckAccessPermission(enMainMenuPermissions Permission) {
+bool ConvertUsersLineDataToRecord(string_view Line, stUser& User, string_view Seperator = "#//#") {
 
-	if (CurrentUser.Permissions == eAll)
-		return true;
+	string_view vUser[3];
 
-	if ((Permission & CurrentUser.Permissions) == Permission)
-		return true;
-	else
+	if (SplitLine(Line, Seperator, vUser, 3) != 3 || vUser[0].empty())
 		return false;
-}
 
-/**
- * @brief Prints a single clients data.
- * @param ClientData Client record.
- */
-void PrintClientsData(stClient ClientData) {
+	if (!ParseNumberField(vUser[2], User.Permissions))
+		return false;
 
-	cout << "| " << left << setw(15) << ClientData.AccountNumber;
-	cout << "| " << left << setw(10) << ClientData.PinCode;
-	cout << "| " << left << setw(40) << ClientData.FullName;
-	cout << "| " << left << setw(12) << ClientData.PhoneNumber;
-	cout << "| " << left << setw(12) << ClientData.AccountBalance;
+	User.UserName.assign(vUser[0]);
+	User.Password.assign(vUser[1]);
+	User.MarkForDelete = false;
+
+	return true;
 }
 
 /**
- * @brief Prints a single users data.
- * @param user user record.
+ * @brief Reports a line that could not be parsed.
+ * @param FileName File the line was read from.
+ * @param LineNumber Line number, starting at 1.
  */
-void PrintUsersData(stUser User) {
+void ReportMalformedLine(const string& FileName, size_t LineNumber) {
 
-	cout << "| " << left << setw(15) << User.UserName;
-	cout << "| " << left << setw(10) << User.Password;
-	cout << "| " << left << setw(40) << User.Permissions;
+	cerr << "Warning: " << FileName << " line " << LineNumber << " is malformed and was skipped.\n";
 }
 
 /**
- * @brief Prints client account balance for total balances screen.
- * @param ClientData Client record.
+ * @brief Removes a trailing carriage return left by files saved with CRLF line ends.
+ * @param Line Line read by getline.
+ * @return Line without the carriage return.
  */
-void PrintClientsDataForTotalBalances(stClient ClientData) {
+string_view TrimLineEnd(string_view Line) {
 
-	cout << "| " << left << setw(15) << ClientData.AccountNumber;
-	cout << "| " << left << setw(40) << ClientData.FullName;
-	cout << "| " << left << setw(12) << ClientData.AccountBalance;
+	if (!Line.empty() && Line.back() == '\r')
+		Line.remove_suffix(1);
+
+	return Line;
 }
 
 /**
- * @brief Displays a formatted list of all clients in the system.
+ * @brief Maps a whole file read-only into memory.
+ *
+ * An empty file is mapped as a null Data with a Size of 0.
  *
- * This function:
- * - First checks if the current user has the permission to view clients
- *   using CheckAccessPermission(pListClients).
- * - If access is denied, it shows an "Access Denied" message and
- *   redirects back to the main menu.
- * - If access is granted, it loads all clients from the file
- *   specified by ClientFileName.
- * - Prints a formatted table with columns for:
- *   - Account Number
- *   - Pin Code
- *   - Client Name
- *   - Phone
- *   - Balance
+ * @param FileName The file to map.
+ * @param File Output mapped file, to be released with CloseMappedFile.
+ * @return True if the file was mapped, false if it could not be opened.
  */
-void PrintAllClientsData() {
+bool OpenMappedFile(const string& FileName, stMappedFile& File) {
 
-	if (!CheckAccessPermission(pListClients)) {
-		ShowAccesDeniedMessage();
-		GoBackToMainMenu();
-		return;
-	}
+	File = stMappedFile();
 
-	vector <stClient> vClients;
-	vClients = LoadClientsDataFromFile(ClientFileName);
+#ifdef _WIN32
+	File.FileHandle = CreateFileA(FileName.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (File.FileHandle == INVALID_HANDLE_VALUE)
+		return false;
 
-	cout << "\n\t\t\t\t\tClient List (" << vClients.size() << ") Client(s).";
-	cout << "\n_______________________________________________________";
-	cout << "_________________________________________\n" << endl;
-	cout << "| " << left << setw(15) << "Accout Number";
-	cout << "| " << left << setw(10) << "Pin Code";
-	cout << "| " << left << setw(40) << "Client Name";
-	cout << "| " << left << setw(12) << "Phone";
-	cout << "| " << left << setw(12) << "Balance";
-	cout << "\n_______________________________________________________";
-	cout << "_________________________________________\n" << endl;
+	LARGE_INTEGER FileSize;
+	if (!GetFileSizeEx(File.FileHandle, &FileSize) || FileSize.QuadPart == 0)
+		return true;
 
-	for (stClient& Client : vClients) {
-		PrintClientsData(Client);
-		cout << endl;
-	}
+	File.MappingHandle = CreateFileMappingA(File.FileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (File.MappingHandle == NULL)
+		return false;
 
-	cout << "\n_______________________________________________________";
-	cout << "_________________________________________\n" << endl;
+	File.Data = (const char*)MapViewOfFile(File.MappingHandle, FILE_MAP_READ, 0, 0, 0);
+	if (File.Data == nullptr)
+		return false;
+
+	File.Size = (size_t)FileSize.QuadPart;
+#else
+	File.FileDescriptor = open(FileName.c_str(), O_RDONLY);
+	if (File.FileDescriptor < 0)
+		return false;
+
+	struct stat FileStat;
+	if (fstat(File.FileDescriptor, &FileStat) != 0 || FileStat.st_size == 0)
+		return true;
+
+	void* Data = mmap(nullptr, (size_t)FileStat.st_size, PROT_READ, MAP_PRIVATE, File.FileDescriptor, 0);
+	if (Data == MAP_FAILED)
+		return false;
+
+	madvise(Data, (size_t)FileStat.st_size, MADV_SEQUENTIAL);
+	File.Data = (const char*)Data;
+	File.Size = (size_t)FileStat.st_size;
+#endif
+
+	return true;
 }
 
 /**
- * @brief Displays a formatted list of all users in the system.
+ * @brief Unmaps a file mapped by OpenMappedFile.
+ * @param File Mapped file.
  */
-void PrintAllUsersData() {
+void CloseMappedFile(stMappedFile& File) {
+
+#ifdef _WIN32
+	if (File.Data != nullptr)
+		UnmapViewOfFile(File.Data);
+	if (File.MappingHandle != NULL)
+		CloseHandle(File.MappingHandle);
+	if (File.FileHandle != INVALID_HANDLE_VALUE)
+		CloseHandle(File.FileHandle);
+#else
+	if (File.Data != nullptr)
+		munmap((void*)File.Data, File.Size);
+	if (File.FileDescriptor >= 0)
+		close(File.FileDescriptor);
+#endif
+
+	File = stMappedFile();
+}
 
-	vector <stUser> vUsers;
-	vUsers = LoadUsersDataFromFile(UserFileName);
+/**
+ * @brief Calls OnLine for every non empty line of a block of text.
+ * @param Data Text to split into lines.
+ * @param OnLine Called with the line, without its line end, and its line number.
+ */
+template <typename LineCallback>
+void ForEachLine(string_view Data, LineCallback OnLine) {
 
-	cout << "\n\t\t\t\t\tUsers List (" << vUsers.size() << ") User(s).";
-	cout << "\n_______________________________________________________";
-	cout << "_________________________________________\n" << endl;
-	cout << "| " << left << setw(15) << "User Name";
-	cout << "| " << left << setw(10) << "Password";
-	cout << "| " << left << setw(40) << "Permissions";
-	cout << "\n_______________________________________________________";
-	cout << "_________________________________________\n" << endl;
+	const char* Pos = Data.data();
+	const char* End = Data.data() + Data.size();
+	size_t LineNumber = 0;
 
-	if (vUsers.size() == 0)
-		cout << "\t\t\t\tNo users Availabla in the System!";
-	else {
-		for (stUser& User : vUsers) {
-			PrintUsersData(User);
-			cout << endl;
-		}
-	}
+	while (Pos < End) {
+		const char* NewLine = (const char*)memchr(Pos, '\n', End - Pos);
+		const char* LineEnd = (NewLine != nullptr) ? NewLine : End;
+		string_view Line = TrimLineEnd(string_view(Pos, LineEnd - Pos));
 
-	cout << "\n_______________________________________________________";
-	cout << "_________________________________________\n" << endl;
+		LineNumber++;
+		if (!Line.empty())
+			OnLine(Line, LineNumber);
+
+		Pos = LineEnd + 1;
+	}
 }
 
 /**
- * @brief Prints detailed information for a single client.
- * @param ClientData Client record.
+ * @brief Calls OnLine for every non empty line of a mapped file.
+ * @param File Mapped file.
+ * @param OnLine Called with the line, without its line end, and its line number.
  */
-void PrintClientData(stClient ClientData) {
+template <typename LineCallback>
+void ForEachLine(const stMappedFile& File, LineCallback OnLine) {
 
-	cout << "\n\nThe Following are the client details: \n\n";
-	cout << "Account Number  : " << ClientData.AccountNumber << endl;
-	cout << "PinCode         : " << ClientData.PinCode << endl;
-	cout << "Name            : " << ClientData.FullName << endl;
-	cout << "Phone           : " << ClientData.PhoneNumber << endl;
-	cout << "Account Balance : " << ClientData.AccountBalance << endl;
+	ForEachLine(string_view(File.Data, File.Size), OnLine);
 }
 
 /**
- * @brief Prints detailed information for a single user.
- * @param User user record.
+ * @brief Counts the lines of a mapped file, used to size vectors before loading.
+ * @param File Mapped file.
+ * @return Number of lines.
  */
-void PrintUserData(stUser User) {
+size_t CountLines(const stMappedFile& File) {
 
-	cout << "\n\nThe Following are the User details: \n\n";
-	cout << "Username    : " << User.UserName << endl;
-	cout << "Password    : " << User.Password << endl;
-	cout << "Permissions : " << User.Permissions << endl;
+	return (size_t)count(File.Data, File.Data + File.Size, '\n') + 1;
 }
 
 /**
- * @brief Appends a line of text to the end of a file.
+ * @brief Loads all clients from file.
  *
- * This function opens a file in append mode and writes the given line
- * followed by a newline character. If the file cannot be opened, the
- * function does nothing.
+ * The file is mapped into memory and every record is parsed straight
+ * out of the mapped pages. Malformed lines are reported with their line
+ * number and skipped.
  *
- * @param Line The text line to append to the file.
- * @param FileName The name (or path) of the file to which the line will be written.
+ * @param FileName The file to read from.
+ * @return Vector of clients.
  */
-void AddDataLineToFile(string Line, string FileName) {
+vector <stClient> LoadClientsDataFromFile(string FileName) {
 
-	fstream DataFile;
-	DataFile.open(FileName, ios::out | ios::app);
+	vector <stClient> vFileContent;
+	stMappedFile MyFile;
 
-	if (DataFile.is_open()) {
-		DataFile << Line << endl;
-		DataFile.close();
+	if (OpenMappedFile(FileName, MyFile)) {
+		stClient Client;
+		vFileContent.reserve(CountLines(MyFile));
+
+		ForEachLine(MyFile, [&](string_view Line, size_t LineNumber) {
+			if (ConvertClientsLineDataToRecord(Line, Client))
+				vFileContent.push_back(Client);
+			else
+				ReportMalformedLine(FileName, LineNumber);
+		});
 	}
+
+	CloseMappedFile(MyFile);
+	return vFileContent;
 }
 
 /**
- * @brief Saves client data into file.
- * @param FileName Target file.
- * @param vClients Vector of clients.
- * @return Vector of saved clients.
+ * @brief Maps a records file and finds its lines without parsing them.
+ * @param FileName The file to map.
+ * @param Records Output lazy file, to be released with CloseLazyRecordsFile.
+ * @return True if the file was mapped, false otherwise.
  */
-vector <stClient> SaveClientDataToFile(string FileName, vector <stClient> vClients) {
-	fstream MyFile;
+bool OpenLazyRecordsFile(const string& FileName, stLazyRecordsFile& Records) {
 
-	MyFile.open(FileName, ios::out);
-	string DataLine;
-	if (MyFile.is_open()) {
+	Records.vLines.clear();
+	Records.vLineNumbers.clear();
 
-		for (stClient& C : vClients) {
-			if (C.MarkForDelete != true) {
-				DataLine = ConvertRecordToLine(C, "#//#");
-				MyFile << DataLine << endl;
-			}
-		}
+	if (!OpenMappedFile(FileName, Records.File))
+		return false;
 
-		MyFile.close();
-	}
+	ForEachLine(Records.File, [&](string_view Line, size_t LineNumber) {
+		Records.vLines.push_back(Line);
+		Records.vLineNumbers.push_back(LineNumber);
+	});
 
-	return vClients;
+	return true;
 }
 
 /**
- * @brief Saves user data into file.
- * @param FileName Target file.
- * @param vUsers Vector of users.
- * @return Vector of saved users.
+ * @brief Unmaps a lazy records file.
+ * @param Records Lazy records file.
  */
-vector <stUser> SaveUserDataToFile(string FileName, vector <stUser> vUsers) {
-	fstream MyFile;
+void CloseLazyRecordsFile(stLazyRecordsFile& Records) {
 
-	MyFile.open(FileName, ios::out);
-	string DataLine;
-	if (MyFile.is_open()) {
+	Records.vLines.clear();
+	Records.vLineNumbers.clear();
+	CloseMappedFile(Records.File);
+}
 
-		for (stUser& U : vUsers) {
-			if (U.MarkForDelete != true) {
-				DataLine = ConvertRecordToLine(U, "#//#");
-				MyFile << DataLine << endl;
-			}
-		}
+/**
+ * @brief Parses the users of a lazy records file.
+ *
+ * Every line is parsed straight out of the mapped pages. Malformed lines
+ * are reported with their line number and skipped.
+ *
+ * @param Records Lazy records file of the users.
+ * @param FileName The file the records were mapped from.
+ * @return Vector of users.
+ */
+vector <stUser> ParseUsersRecords(const stLazyRecordsFile& Records, const string& FileName) {
 
-		MyFile.close();
+	vector <stUser> vUsers;
+	stUser User;
+	vUsers.reserve(Records.vLines.size());
+
+	for (size_t i = 0; i < Records.vLines.size(); i++) {
+		if (ConvertUsersLineDataToRecord(Records.vLines[i], User))
+			vUsers.push_back(User);
+		else
+			ReportMalformedLine(FileName, Records.vLineNumbers[i]);
 	}
 
 	return vUsers;
 }
 
 /**
- * @brief Checks if an account number already exists.
- * @param AccountNumber The account number to check.
- * @return True if exists, false otherwise.
+ * @brief Gets the first field of a record line, which is its key.
+ * @param Line Record line.
+ * @param Seperator Delimiter between fields.
+ * @return The key field.
  */
-bool CheckAccountNumberExist(string AccountNumber) {
-	vector <stClient> vClientDataFile = LoadClientsDataFromFile("ClientDataFile.txt");
+string_view GetRecordKey(string_view Line, string_view Seperator = "#//#") {
 
-	for (stClient& C : vClientDataFile) {
-		if (C.AccountNumber == AccountNumber) {
-			cout << "Client With [" << AccountNumber << "] already exists, Enter another Account Number? ";
-			return true;
-		}
+	return Line.substr(0, Line.find(Seperator));
+}
+
+/**
+ * @brief Rebuilds the username index of the users repository.
+ */
+void BuildUserNameIndex() {
+
+	UsersRepository.UserNameIndex.clear();
+	UsersRepository.UserNameIndex.reserve(UsersRepository.vUsers.size());
+
+	for (size_t i = 0; i < UsersRepository.vUsers.size(); i++) {
+		if (UsersRepository.vUsers[i].MarkForDelete != true)
+			UsersRepository.UserNameIndex[UsersRepository.vUsers[i].UserName] = i;
 	}
-	return false;
 }
 
 /**
- * @brief Checks if a given username already exists in the users database.
- *
- * This function loads all users from the file, then iterates through the list
- * to determine if the provided username is already in use.
- *
- * @param UserName The username to check for existence.
- * @return True if the username already exists, otherwise false.
+ * @brief Replays the user journal on top of the loaded users. Each line
+ *        is a delete record, X#//#UserName, deletes of unknown users are skipped.
+ * @param FileName The journal file to read from.
  */
-bool CheckUserNameExist(string UserName) {
-	vector <stUser> vUsers = LoadUsersDataFromFile(UserFileName);
+void ReplayUserJournal(string FileName) {
 
-	for (stUser& U : vUsers) {
-		if (U.UserName == UserName) {
-			cout << "User With [" << UserName << "] already exists, Enter another UserName? ";
-			return true;
+	fstream MyFile;
+	MyFile.open(FileName, ios::in);
+
+	if (MyFile.is_open()) {
+		string Line;
+		size_t LineNumber = 0;
+
+		while (getline(MyFile, Line)) {
+			LineNumber++;
+			string_view vRecord[2];
+
+			if (SplitLine(TrimLineEnd(Line), "#//#", vRecord, 2) != 2 || vRecord[0] != "X") {
+				ReportMalformedLine(FileName, LineNumber);
+				continue;
+			}
+
+			auto It = UsersRepository.UserNameIndex.find(string(vRecord[1]));
+
+			if (It != UsersRepository.UserNameIndex.end()) {
+				UsersRepository.vUsers[It->second].MarkForDelete = true;
+				UsersRepository.UserNameIndex.erase(It);
+				UsersRepository.DeletedUsers++;
+			}
 		}
+
+		MyFile.close();
 	}
-	return false;
 }
 
 /**
- * @brief Searches for a user by username in the users database.
+ * @brief Parses the mapped users file into the users repository and
+ *        replays the user journal on top of it, once per load.
  *
- * This function loads all users from the file and iterates through them to find
- * a match with the provided username. If a match is found, the corresponding
- * user data is copied into the output parameter.
- *
- * @param UserName The username to search for.
- * @param User Reference to a stUser object where the found user data will be stored.
- * @return True if the user was found, otherwise false.
+ * The caller holds UsersMutex. Runs that never touch a user, such as
+ * posting and end of day runs, never pay for the parse.
  */
-bool FindUserByUserName(string UserName, stUser& User) {
-	vector <stUser> vUsers = LoadUsersDataFromFile(UserFileName);
+void ParsePendingUsers() {
 
-	for (stUser& U : vUsers) {
-		if (U.UserName == UserName) {
-			User = U;
-			return true;
-		}
-	}
-	return false;
+	if (!UsersRepository.LinesPending)
+		return;
+
+	UsersRepository.vUsers = ParseUsersRecords(PendingUsersFile, UserFileName);
+	UsersRepository.DeletedUsers = 0;
+	UsersRepository.LinesPending = false;
+	CloseLazyRecordsFile(PendingUsersFile);
+	BuildUserNameIndex();
+	ReplayUserJournal(UserJournalFileName);
 }
 
 /**
- * @brief Reads client data from user input.
- * @param ClientData Reference to stClient.
- * @return Filled client record.
+ * @brief Converts client record into a file line.
+ * @param ClientData Client data.
+ * @param Seprator Field separator.
+ * @return String line for file storage.
  */
-stClient ReadClientData(stClient& ClientData) {
+string ConvertRecordToLine(stClient& ClientData, string Seprator) {
 
-	cout << "Enter Account Number? ";
-	do {
-		getline(cin >> ws, ClientData.AccountNumber);
-	} while (CheckAccountNumberExist(ClientData.AccountNumber));
+	string stClientRecord = "";
 
-	cout << "Enter PinCode? ";
-	getline(cin, ClientData.PinCode);
+	stClientRecord += ClientData.AccountNumber + Seprator;
+	stClientRecord += ClientData.PinCode + Seprator;
+	stClientRecord += ClientData.FullName + Seprator;
+	stClientRecord += ClientData.PhoneNumber + Seprator;
+	stClientRecord += FormatMoney(ClientData.AccountBalance);
 
-	cout << "Enter Name? ";
-	getline(cin, ClientData.FullName);
+	return stClientRecord;
+}
 
-	cout << "Enter Phone? ";
-	getline(cin, ClientData.PhoneNumber);
+/**
+ * @brief Converts user record into a file line.
+ * @param User user data.
+ * @param Seprator Field separator.
+ * @return String line for file storage.
+ */
+string ConvertRecordToLine(stUser& User, string Seprator) {
 
-	cout << "Enter AccountBalance? ";
-	cin >> ClientData.AccountBalance;
+	string stUserRecord = "";
 
-	return ClientData;
+	stUserRecord += User.UserName + Seprator;
+	stUserRecord += User.Password + Seprator;
+	stUserRecord += to_string(User.Permissions);
+
+	return stUserRecord;
 }
 
 /**
- * @brief Reads and assigns access permissions for a user.
- *
- * This function interacts with the console to configure a user's permissions.
- * It first checks if the user should have full access (all permissions).
- * If not, it prompts the administrator to grant specific permissions one by one.
- *
- * Permissions are represented as integer flags (bitmask).
- * - If full access is granted, the function returns -1 (special flag for all permissions).
- * - Otherwise, the function accumulates the selected permissions and returns the sum.
- *`
- *
- * @return An integer representing the user's granted permissions.
+ * @brief Starts a SHA-256 computation.
+ * @param Context Context to reset.
  */
-int ReadPermissions() {
-	char Answer = 'n';
-	int Permissions = 0;
+void Sha256Init(stSha256& Context) {
 
-	do {
-		cout << "\nDo you want to give full access? Y/N? ";
-		cin >> Answer;
-	} while (toupper(Answer) != 'Y' && toupper(Answer) != 'N');
+	static const uint32_t InitialState[8] = {
+		0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
 
-	if (toupper(Answer) == 'Y')
-		return -1;
+	memcpy(Context.State, InitialState, sizeof(InitialState));
+	Context.Length = 0;
+	Context.BufferSize = 0;
+}
 
-	cout << "\nDo you want to give to? \n";
+/**
+ * @brief Mixes one 64-byte block into a SHA-256 state.
+ * @param State Hash state.
+ * @param Block Block to mix.
+ */
+void Sha256Transform(uint32_t State[8], const uint8_t Block[64]) {
 
-	cout << "\nShow Client List? y/n? ";
-	cin >> Answer;
-	if (toupper(Answer) == 'Y')
-		Permissions += pListClients;
+	static const uint32_t RoundConstants[64] = {
+		0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+		0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+		0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+		0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+		0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+		0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+		0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+		0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2 };
 
-	cout << "\nAdd New Client? y/n? ";
-	cin >> Answer;
-	if (toupper(Answer) == 'Y')
-		Permissions += pAddNewClients;
+	auto Rotate = [](uint32_t Value, int Bits) { return (Value >> Bits) | (Value << (32 - Bits)); };
 
-	cout << "\nDelete Client? y/n? ";
-	cin >> Answer;
-	if (toupper(Answer) == 'Y')
-		Permissions += pDeleteClient;
+	uint32_t W[64];
 
-	cout << "\nUpdate Client? y/n? ";
-	cin >> Answer;
-	if (toupper(Answer) == 'Y')
-		Permissions += pUpdateClient;
+	for (int i = 0; i < 16; i++)
+		W[i] = ((uint32_t)Block[i * 4] << 24) | ((uint32_t)Block[i * 4 + 1] << 16) | ((uint32_t)Block[i * 4 + 2] << 8) | Block[i * 4 + 3];
 
-	cout << "\nFind Client? y/n? ";
-	cin >> Answer;
-	if (toupper(Answer) == 'Y')
-		Permissions += pFindClient;
+	for (int i = 16; i < 64; i++) {
+		uint32_t S0 = Rotate(W[i - 15], 7) ^ Rotate(W[i - 15], 18) ^ (W[i - 15] >> 3);
+		uint32_t S1 = Rotate(W[i - 2], 17) ^ Rotate(W[i - 2], 19) ^ (W[i - 2] >> 10);
+		W[i] = W[i - 16] + S0 + W[i - 7] + S1;
+	}
 
-	cout << "\nTransactions? y/n? ";
-	cin >> Answer;
-	if (toupper(Answer) == 'Y')
-		Permissions += pTransactions;
+	uint32_t a = State[0], b = State[1], c = State[2], d = State[3];
+	uint32_t e = State[4], f = State[5], g = State[6], h = State[7];
 
-	cout << "\nmanage Users? y/n? ";
-	cin >> Answer;
-	if (toupper(Answer) == 'Y')
-		Permissions += pManageUsers;
+	for (int i = 0; i < 64; i++) {
+		uint32_t T1 = h + (Rotate(e, 6) ^ Rotate(e, 11) ^ Rotate(e, 25)) + ((e & f) ^ (~e & g)) + RoundConstants[i] + W[i];
+		uint32_t T2 = (Rotate(a, 2) ^ Rotate(a, 13) ^ Rotate(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+		h = g; g = f; f = e; e = d + T1;
+		d = c; c = b; b = a; a = T1 + T2;
+	}
 
-	return Permissions;
+	State[0] += a; State[1] += b; State[2] += c; State[3] += d;
+	State[4] += e; State[5] += f; State[6] += g; State[7] += h;
 }
 
 /**
- * @brief Reads user data from user input.
- * @param User Reference to stUser.
- * @return Filled user record.
+ * @brief Adds data to a SHA-256 computation.
+ * @param Context Hash context.
+ * @param Data Data to add.
+ * @param Size Size of the data in bytes.
  */
-stUser ReadUserData(stUser& User) {
+void Sha256Update(stSha256& Context, const void* Data, size_t Size) {
 
-	cout << "Enter UserName? ";
-	do {
-		getline(cin >> ws, User.UserName);
-	} while (CheckUserNameExist(User.UserName));
+	const uint8_t* Bytes = (const uint8_t*)Data;
+	Context.Length += Size;
 
-	cout << "Enter Password? ";
-	getline(cin, User.Password);
+	while (Size > 0) {
+		size_t Count = min(Size, sizeof(Context.Buffer) - Context.BufferSize);
 
-	User.Permissions = ReadPermissions();
+		memcpy(Context.Buffer + Context.BufferSize, Bytes, Count);
+		Context.BufferSize += Count;
+		Bytes += Count;
+		Size -= Count;
 
-	return User;
+		if (Context.BufferSize == sizeof(Context.Buffer)) {
+			Sha256Transform(Context.State, Context.Buffer);
+			Context.BufferSize = 0;
+		}
+	}
 }
 
 /**
- * @brief Reads an account number from user input.
- * @return Account number.
+ * @brief Finishes a SHA-256 computation.
+ * @param Context Hash context, not usable afterwards.
+ * @param Digest Output 32-byte digest.
  */
-string ReadClientAccountNumber() {
-	string AccountNumber;
+void Sha256Final(stSha256& Context, uint8_t Digest[32]) {
 
-	cout << "\nPlease Enter Account Number? ";
-	cin >> AccountNumber;
-
-	return AccountNumber;
-}
+	uint64_t BitLength = Context.Length * 8;
+	uint8_t Padding[72] = { 0x80 };
+	size_t PaddingSize = (Context.BufferSize < 56) ? 56 - Context.BufferSize : 120 - Context.BufferSize;
 
-/**
- * @brief Finds a client by account number.
- * @param AccountNumber Account number.
- * @param vClients Vector of clients.
- * @param Client Output client.
- * @return True if found, false otherwise.
- */
-bool FindClientByAccountNumber(string AccountNumber, vector <stClient> vClients, stClient& Client) {
+	for (int i = 0; i < 8; i++)
+		Padding[PaddingSize + i] = (uint8_t)(BitLength >> (56 - i * 8));
 
-	for (stClient& C : vClients) {
-		if (C.AccountNumber == AccountNumber) {
-			Client = C;
-			return true;
-		}
-	}
+	Sha256Update(Context, Padding, PaddingSize + 8);
 
-	return false;
+	for (int i = 0; i < 32; i++)
+		Digest[i] = (uint8_t)(Context.State[i / 4] >> (24 - (i % 4) * 8));
 }
 
 /**
- * @brief Finds a user by username.
- * @param UserName username.
- * @param User Output user.
- * @param Password 
- * @return True if found, false otherwise.
+ * @brief Computes the SHA-256 digest of some data.
+ * @param Data Data to hash.
+ * @return 32-byte digest.
  */
-bool FindUserByUserNameAndPassword(string UserName, string Password, stUser& User) {
-	vector <stUser> vUsers = LoadUsersDataFromFile(UserFileName);
+string ComputeSha256(string_view Data) {
 
-	for (stUser& U : vUsers) {
-		if (U.UserName == UserName && U.Password == Password) {
-			User = U;
-			return true;
-		}
-	}
+	stSha256 Context;
+	uint8_t Digest[32];
 
-	return false;
+	Sha256Init(Context);
+	Sha256Update(Context, Data.data(), Data.size());
+	Sha256Final(Context, Digest);
+
+	return string((const char*)Digest, sizeof(Digest));
 }
 
 /**
- * @brief Loads user information based on username and password.
+ * @brief Derives a password hash with PBKDF2-HMAC-SHA256.
  *
- * This function attempts to find a user in the system using the provided
- * username and password. If a matching user is found, the user's details
- * are loaded into the global variable `CurrentUser`.
+ * The inner and outer HMAC states are computed once, so each round
+ * costs two SHA-256 blocks.
  *
- * @param UserName The username to search for.
- * @param Password The password to validate.
- * @return True if the user was found and authenticated successfully,
- *         otherwise false.
+ * @param Password The password.
+ * @param Salt Random salt of the user.
+ * @param Iterations Number of rounds, the work factor.
+ * @return 32-byte derived key.
  */
-bool LoadUserInfo(string UserName, string Password) {
+string DerivePasswordHash(string_view Password, string_view Salt, int Iterations) {
 
-	if (FindUserByUserNameAndPassword(UserName, Password, CurrentUser))
-		return true;
-	else
-		return false;
-}
+	uint8_t KeyBlock[64] = {};
 
-/**
- * @brief Marks a client for deletion by account number.
- * @param AccountNumber Account number.
- * @param vClients Vector of clients.
- * @return True if marked, false otherwise.
- */
-bool MarkClientForDeleteByAccountNumber(string AccountNumber, vector <stClient>& vClients) {
-	for (stClient& C : vClients) {
-		if (C.AccountNumber == AccountNumber) {
-			C.MarkForDelete = true;
-			return true;
-		}
+	if (Password.size() > sizeof(KeyBlock)) {
+		string KeyDigest = ComputeSha256(Password);
+		memcpy(KeyBlock, KeyDigest.data(), KeyDigest.size());
 	}
+	else
+		memcpy(KeyBlock, Password.data(), Password.size());
 
-	return false;
-}
+	stSha256 Inner, Outer;
+	uint8_t InnerPad[64], OuterPad[64];
 
-/**
- * @brief Marks a user for deletion by username.
- * @param Username.
- * @param vUsers Vector of users.
- * @return True if marked, false otherwise.
- */
-bool MarkUserForDeleteByUsername(string Username, vector <stUser>& vUsers) {
-	for (stUser& U : vUsers) {
-		if (U.UserName == Username) {
-			U.MarkForDelete = true;
-			return true;
-		}
+	for (int i = 0; i < 64; i++) {
+		InnerPad[i] = KeyBlock[i] ^ 0x36;
+		OuterPad[i] = KeyBlock[i] ^ 0x5c;
 	}
 
-	return false;
-}
+	Sha256Init(Inner);
+	Sha256Update(Inner, InnerPad, sizeof(InnerPad));
+	Sha256Init(Outer);
+	Sha256Update(Outer, OuterPad, sizeof(OuterPad));
 
-/**
- * @brief Deletes a client by account number.
- * @param AccountNumber Account number.
- * @param vClients Vector of clients.
- * @return True if deleted, false otherwise.
- */
-bool DeleteClientByAccountNumber(string AccountNumber, vector <stClient>& vClients) {
+	auto Hmac = [&](const uint8_t* Data, size_t Size, uint8_t Output[32]) {
+		stSha256 Context = Inner;
+		Sha256Update(Context, Data, Size);
+		Sha256Final(Context, Output);
 
-	stClient Client;
-	char Answer = 'N';
+		Context = Outer;
+		Sha256Update(Context, Output, 32);
+		Sha256Final(Context, Output);
+	};
 
-	if (FindClientByAccountNumber(AccountNumber, vClients, Client)) {
-		PrintClientData(Client);
+	string FirstBlock = string(Salt) + string("\0\0\0\1", 4);
+	uint8_t Round[32], Result[32];
 
-		cout << "\nAre you sure you want to delete this client? Y/N? ";
-		cin >> Answer;
-		if (toupper(Answer) == 'Y') {
-			MarkClientForDeleteByAccountNumber(AccountNumber, vClients);
-			SaveClientDataToFile(ClientFileName, vClients);
+	Hmac((const uint8_t*)FirstBlock.data(), FirstBlock.size(), Round);
+	memcpy(Result, Round, sizeof(Result));
 
-			vClients = LoadClientsDataFromFile(ClientFileName);
+	for (int r = 1; r < Iterations; r++) {
+		Hmac(Round, sizeof(Round), Round);
 
-			cout << "\n\nClient deleted Successfully" << endl;
-			return true;
-		}
-	}
-	else {
-		cout << "\nClient with Account Number (" << AccountNumber << ") is Not Found!\n";
-		return false;
+		for (int i = 0; i < 32; i++)
+			Result[i] ^= Round[i];
 	}
+
+	return string((const char*)Result, sizeof(Result));
 }
 
 /**
- * @brief Deletes a user by username.
- * @param UserName.
- * @param vUsers Vector of users.
- * @return True if deleted, false otherwise.
+ * @brief Converts bytes into lowercase hexadecimal text.
+ * @param Bytes The bytes.
+ * @return Hexadecimal text, two digits per byte.
  */
-bool DeleteUserByUsername(string UserName, vector <stUser>& vUsers) {
+string ConvertBytesToHex(string_view Bytes) {
 
-	if (UserName == "Admin") {
-		cout << "\n\nYou cannot Delete This User.";
-		return false;
+	static const char Digits[] = "0123456789abcdef";
+	string Hex;
+
+	Hex.reserve(Bytes.size() * 2);
+	for (unsigned char Byte : Bytes) {
+		Hex += Digits[Byte >> 4];
+		Hex += Digits[Byte & 15];
 	}
 
-	stUser User;
-	char Answer = 'N';
+	return Hex;
+}
 
-	if (FindUserByUserName(UserName, User)) {
-		PrintUserData(User);
+/**
+ * @brief Converts hexadecimal text back into bytes.
+ * @param Hex Hexadecimal text.
+ * @param Bytes Output bytes.
+ * @return True if the text is valid hexadecimal, false otherwise.
+ */
+bool ConvertHexToBytes(string_view Hex, string& Bytes) {
 
-		cout << "\nAre you sure you want to delete this client? Y/N? ";
-		cin >> Answer;
-		if (toupper(Answer) == 'Y') {
-			MarkUserForDeleteByUsername(UserName, vUsers);
-			SaveUserDataToFile(UserFileName, vUsers);
+	if (Hex.size() % 2 != 0)
+		return false;
 
-			vUsers = LoadUsersDataFromFile(UserFileName);
+	Bytes.assign(Hex.size() / 2, '\0');
 
-			cout << "\nUser deleted Successfully" << endl;
-			return true;
-		}
-	}
-	else {
-		cout << "\nClient with Username (" << UserName << ") is Not Found!\n";
-		return false;
+	for (size_t i = 0; i < Bytes.size(); i++) {
+		unsigned Byte = 0;
+		from_chars_result Result = from_chars(Hex.data() + i * 2, Hex.data() + i * 2 + 2, Byte, 16);
+
+		if (Result.ec != errc() || Result.ptr != Hex.data() + i * 2 + 2)
+			return false;
+
+		Bytes[i] = (char)Byte;
 	}
+
+	return true;
 }
 
 /**
- * @brief Updates a clients record by re-entering data.
- * @param AccountNumber The account number.
- * @return Updated client record.
+ * @brief Generates random bytes for salts and keys.
+ * @param Size Number of bytes.
+ * @return The random bytes.
  */
-stClient UpdateClientRecord(string AccountNumber) {
+string GenerateRandomBytes(size_t Size) {
 
-	stClient ClientData;
+	random_device Random;
+	string Bytes(Size, '\0');
 
-	ClientData.AccountNumber = AccountNumber;
+	for (char& Byte : Bytes)
+		Byte = (char)(Random() & 0xff);
 
-	cout << "\nEnter PinCode? ";
-	getline(cin >> ws, ClientData.PinCode);
+	return Bytes;
+}
 
-	cout << "Enter Name? ";
-	getline(cin, ClientData.FullName);
+/**
+ * @brief Compares two strings in a time that does not depend on where they differ.
+ * @param A First string.
+ * @param B Second string.
+ * @return True if the strings are equal, false otherwise.
+ */
+bool EqualInConstantTime(string_view A, string_view B) {
 
-	cout << "Enter Phone? ";
-	getline(cin, ClientData.PhoneNumber);
+	if (A.size() != B.size())
+		return false;
 
-	cout << "Enter AccountBalance? ";
-	cin >> ClientData.AccountBalance;
+	unsigned char Difference = 0;
+	for (size_t i = 0; i < A.size(); i++)
+		Difference |= (unsigned char)(A[i] ^ B[i]);
 
-	return ClientData;
+	return Difference == 0;
 }
 
 /**
- * @brief Updates a users record by re-entering data.
- * @param Username.
- * @return Updated user record.
+ * @brief Checks if a stored password is a hash or a legacy plaintext password.
+ * @param StoredPassword Password field of the users file.
+ * @return True if it is a hash, false otherwise.
  */
-stUser UpdateUserRecord(string Username) {
-
-	stUser User;
+bool IsPasswordHashed(const string& StoredPassword) {
 
-	User.UserName = Username;
+	return StoredPassword.compare(0, PasswordHashPrefix.size(), PasswordHashPrefix) == 0;
+}
 
-	cout << "Enter Password? ";
-	getline(cin >> ws, User.Password);
+/**
+ * @brief Hashes a password with a new random salt.
+ * @param Password The plaintext password.
+ * @return Stored form: $pbkdf2-sha256$Iterations$Salt$Hash, salt and hash in hexadecimal.
+ */
+string HashPassword(const string& Password) {
 
-	User.Permissions = ReadPermissions();
+	string Salt = GenerateRandomBytes(16);
 
-	return User;
+	return PasswordHashPrefix + to_string(PasswordHashIterations) + "$" + ConvertBytesToHex(Salt) + "$"
+		+ ConvertBytesToHex(DerivePasswordHash(Password, Salt, PasswordHashIterations));
 }
 
 /**
- * @brief Updates a client in file by account number.
- * @param AccountNumber The account number.
- * @param vClients Vector of clients.
- * @return True if updated, false otherwise.
+ * @brief Checks a password against its stored form.
+ *
+ * Legacy plaintext passwords are compared as they are, they are hashed
+ * on the next successful login.
+ *
+ * @param StoredPassword Password field of the users file.
+ * @param Password The password to check.
+ * @return True if the password matches, false otherwise.
  */
-bool UpdateClientByAccountNumber(string AccountNumber, vector <stClient>& vClients) {
-
-	stClient Client;
-	char Answer = 'N';
+bool VerifyPassword(const string& StoredPassword, const string& Password) {
 
-	if (FindClientByAccountNumber(AccountNumber, vClients, Client)) {
-		PrintClientData(Client);
+	if (!IsPasswordHashed(StoredPassword))
+		return EqualInConstantTime(StoredPassword, Password);
 
-		cout << "\nAre you sure you want to Update this client? Y/N? ";
-		cin >> Answer;
-		if (toupper(Answer) == 'Y') {
-			for (stClient& C : vClients) {
-				if (C.AccountNumber == AccountNumber) {
-					C = UpdateClientRecord(AccountNumber);
-					break;
-				}
-			}
-			SaveClientDataToFile(ClientFileName, vClients);
+	string_view vFields[3];
+	int Iterations = 0;
+	string Salt, Hash;
 
-			cout << "\n\nClient Updated Successfully" << endl;
-			return true;
-		}
-	}
-	else {
-		cout << "\nClient with Account Number (" << AccountNumber << ") is Not Found!\n";
+	if (SplitLine(string_view(StoredPassword).substr(PasswordHashPrefix.size()), "$", vFields, 3) != 3
+		|| !ParseNumberField(vFields[0], Iterations) || Iterations < 1
+		|| !ConvertHexToBytes(vFields[1], Salt) || !ConvertHexToBytes(vFields[2], Hash))
 		return false;
-	}
+
+	return EqualInConstantTime(DerivePasswordHash(Password, Salt, Iterations), Hash);
 }
 
 /**
- * @brief Updates a user in file by username.
- * @param Username.
- * @param vUsers Vector of users.
- * @return True if updated, false otherwise.
+ * @brief Computes the rights a user gets for a session.
+ *
+ * eAll becomes every permission bit and unknown bits are dropped, so
+ * checks never need to special-case full access.
+ *
+ * @param Permissions Stored permissions of the user.
+ * @return Effective rights mask.
  */
-bool UpdateUserByUsername(string Username, vector <stUser>& vUsers) {
-
-	stUser User;
-	char Answer = 'N';
+constexpr int GetEffectiveRights(int Permissions) {
 
-	if (FindUserByUserName(Username, User)) {
-		PrintUserData(User);
+	return (Permissions == eAll) ? AllPermissions : (Permissions & AllPermissions);
+}
 
-		cout << "\nAre you sure you want to Update this User? Y/N? ";
-		cin >> Answer;
-		if (toupper(Answer) == 'Y') {
-			for (stUser& U : vUsers) {
-				if (U.UserName == Username) {
-					U = UpdateUserRecord(Username);
-					break;
-				}
-			}
-			SaveUserDataToFile(UserFileName, vUsers);
+/**
+ * @brief Checks if session rights include a given permission.
+ * @param Rights Rights computed by GetEffectiveRights.
+ * @param Permission The required permission.
+ * @return True if the rights include the permission, false otherwise.
+ */
+constexpr bool HasPermission(int Rights, enMainMenuPermissions Permission) {
 
-			cout << "\n\nUser Updated Successfully" << endl;
-			return true;
-		}
-	}
-	else {
-		cout << "\nUser with User Name (" << Username << ") is Not Found!\n";
-		return false;
-	}
+	return (Rights & Permission) == Permission;
 }
 
 /**
- * @brief Adds a single client to the file.
+ * @brief Checks if the currently logged-in user has access to a given permission.
+ *
+ * @param Permission The required permission to check (from enMainMenuPermissions).
+ * @return true  If the current user has the required permission.
+ * @return false If the current user does not have the required permission.
  */
-void AddNewClients() {
-	stClient ClientData;
-	ReadClientData(ClientData);
+bool CheckAccessPermission(enMainMenuPermissions Permission) {
 
-	AddDataLineToFile(ConvertRecordToLine(ClientData, "#//#"), "ClientDataFile.txt");
+	return HasPermission(CurrentRights, Permission);
 }
 
 /**
- * @brief Adds a single user to the file.
+ * @brief Prints a single clients data.
+ * @param ClientData Client record.
  */
-void AddNewUsers() {
-	stUser User;
-	ReadUserData(User);
+void PrintClientsData(stClient ClientData) {
 
-	AddDataLineToFile(ConvertRecordToLine(User, "#//#"), "Users.txt");
+	cout << "| " << left << setw(15) << ClientData.AccountNumber;
+	cout << "| " << left << setw(10) << ClientData.PinCode;
+	cout << "| " << left << setw(40) << ClientData.FullName;
+	cout << "| " << left << setw(12) << ClientData.PhoneNumber;
+	cout << "| " << left << setw(12) << FormatMoney(ClientData.AccountBalance);
 }
 
 /**
- * @brief Adds multiple clients interactively.
+ * @brief Prints a single users data.
+ * @param user user record.
  */
-void AddClient() {
-	char AddMore = 'Y';
+void PrintUsersData(stUser User) {
 
-	do {
-		cout << "Adding New Client:\n\n";
-		AddNewClients();
-		cout << "\nClient Added Successfully, do you want to add more clients? Y/N? ";
-		cin >> AddMore;
-	} while (toupper(AddMore) == 'Y');
+	cout << "| " << left << setw(15) << User.UserName;
+	cout << "| " << left << setw(10) << (IsPasswordHashed(User.Password) ? "(hashed)" : User.Password);
+	cout << "| " << left << setw(40) << User.Permissions;
 }
 
 /**
- * @brief Adds multiple users interactively.
+ * @brief Prints client account balance for total balances screen.
+ * @param ClientData Client record.
  */
-void AddUser() {
-	char AddMore = 'Y';
+void PrintClientsDataForTotalBalances(stClient ClientData) {
 
-	do {
-		cout << "Adding New User:\n\n";
-		AddNewUsers();
-		cout << "\nUser Added Successfully, do you want to add more Users? Y/N? ";
-		cin >> AddMore;
-	} while (toupper(AddMore) == 'Y');
+	cout << "| " << left << setw(15) << ClientData.AccountNumber;
+	cout << "| " << left << setw(40) << ClientData.FullName;
+	cout << "| " << left << setw(12) << FormatMoney(ClientData.AccountBalance);
 }
 
 /**
- * @brief Performs deposit operation for a client.
- * @return True if successful.
+ * @brief Prints the clients found by a search as a table.
+ * @param vClients Found clients.
  */
-bool DepositAmountByClientNumber() {
+void PrintFoundClients(vector <stClient>& vClients) {
 
-	vector <stClient> vClients = LoadClientsDataFromFile(ClientFileName);
-	string AccountNumber = ReadClientAccountNumber();
-	stClient Client;
-	char Answer = 'N';
+	if (vClients.empty()) {
+		cout << "\nNo client matches this search.\n";
+		return;
+	}
 
-	while (!FindClientByAccountNumber(AccountNumber, vClients, Client)) {
-		cout << "Client with [" << AccountNumber << "] does not Found!\n";
-		AccountNumber = ReadClientAccountNumber();
+	cout << "\n\t\t\t\t\tFound (" << vClients.size() << ") Client(s).";
+	cout << "\n_______________________________________________________";
+	cout << "_________________________________________\n" << endl;
+	cout << "| " << left << setw(15) << "Accout Number";
+	cout << "| " << left << setw(10) << "Pin Code";
+	cout << "| " << left << setw(40) << "Client Name";
+	cout << "| " << left << setw(12) << "Phone";
+	cout << "| " << left << setw(12) << "Balance";
+	cout << "\n_______________________________________________________";
+	cout << "_________________________________________\n" << endl;
+
+	for (stClient& Client : vClients) {
+		PrintClientsData(Client);
+		cout << endl;
 	}
 
-	PrintClientData(Client);
-	double DepositAmount = ReadDepositAmount();
+	cout << "\n_______________________________________________________";
+	cout << "_________________________________________\n" << endl;
+}
 
-	cout << "Are you Sure you want perform this transaction? y/n ? ";
-	cin >> Answer;
+/**
+ * @brief Displays a formatted list of all users in the system.
+ */
+void PrintAllUsersData() {
 
-	if (toupper(Answer) == 'Y') {
-		for (stClient& C : vClients) {
-			if (C.AccountNumber == AccountNumber) {
-				C.AccountBalance += DepositAmount;
-				break;
-			}
+	vector <stUser> vUsers;
+	{
+		lock_guard <mutex> Lock(UsersMutex);
+		ParsePendingUsers();
+		vUsers.reserve(UsersRepository.vUsers.size() - UsersRepository.DeletedUsers);
+
+		for (const stUser& User : UsersRepository.vUsers) {
+			if (User.MarkForDelete != true)
+				vUsers.push_back(User);
 		}
-		SaveClientDataToFile(ClientFileName, vClients);
+	}
 
-		cout << "\n\nAmount Deposit Successfully" << endl;
-		return true;
+	cout << "\n\t\t\t\t\tUsers List (" << vUsers.size() << ") User(s).";
+	cout << "\n_______________________________________________________";
+	cout << "_________________________________________\n" << endl;
+	cout << "| " << left << setw(15) << "User Name";
+	cout << "| " << left << setw(10) << "Password";
+	cout << "| " << left << setw(40) << "Permissions";
+	cout << "\n_______________________________________________________";
+	cout << "_________________________________________\n" << endl;
+
+	if (vUsers.size() == 0)
+		cout << "\t\t\t\tNo users Availabla in the System!";
+	else {
+		for (stUser& User : vUsers) {
+			PrintUsersData(User);
+			cout << endl;
+		}
 	}
 
-	return false;
+	cout << "\n_______________________________________________________";
+	cout << "_________________________________________\n" << endl;
 }
 
 /**
- * @brief Performs withdrawal operation for a client.
- * @return True if successful.
+ * @brief Prints detailed information for a single client.
+ * @param ClientData Client record.
  */
-bool WithdrawAmountByClientNumber() {
+void PrintClientData(stClient ClientData) {
 
-	vector <stClient> vClients = LoadClientsDataFromFile(ClientFileName);
-	string AccountNumber = ReadClientAccountNumber();
-	stClient Client;
-	char Answer = 'N';
+	cout << "\n\nThe Following are the client details: \n\n";
+	cout << "Account Number  : " << ClientData.AccountNumber << endl;
+	cout << "PinCode         : " << ClientData.PinCode << endl;
+	cout << "Name            : " << ClientData.FullName << endl;
+	cout << "Phone           : " << ClientData.PhoneNumber << endl;
+	cout << "Account Balance : " << FormatMoney(ClientData.AccountBalance) << endl;
+}
 
-	while (!FindClientByAccountNumber(AccountNumber, vClients, Client)) {
-		cout << "Client with [" << AccountNumber << "] does not Found!\n";
-		AccountNumber = ReadClientAccountNumber();
-	}
+/**
+ * @brief Prints detailed information for a single user.
+ * @param User user record.
+ */
+void PrintUserData(stUser User) {
 
-	PrintClientData(Client);
-	double WithdrawAmount = ReadWithdrawAmount();
+	cout << "\n\nThe Following are the User details: \n\n";
+	cout << "Username    : " << User.UserName << endl;
+	cout << "Password    : " << (IsPasswordHashed(User.Password) ? "(hashed)" : User.Password) << endl;
+	cout << "Permissions : " << User.Permissions << endl;
+}
 
-	while (WithdrawAmount > Client.AccountBalance) {
-		cout << "Amoount Exceeds the balance, you can withdraw up to : " << Client.AccountBalance << endl;
-		WithdrawAmount = ReadWithdrawAmount();
+/**
+ * @brief Writes data to a file and waits until it is on the disk.
+ *
+ * Several records written in one call share one sync, so callers
+ * that batch their writes pay for the disk only once per batch.
+ *
+ * @param FileName The file, created if it does not exist.
+ * @param Data Data to write.
+ * @param Append True to write at the end of the file, false to replace its content.
+ * @return True if the data was written and synced, false otherwise.
+ */
+bool WriteFileDurably(const string& FileName, const string& Data, bool Append) {
+
+	bool Done = true;
+
+#ifdef _WIN32
+	HANDLE FileHandle = CreateFileA(FileName.c_str(), GENERIC_WRITE, FILE_SHARE_READ, NULL,
+		Append ? OPEN_ALWAYS : CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (FileHandle == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER Zero = {};
+	if (Append && !SetFilePointerEx(FileHandle, Zero, NULL, FILE_END))
+		Done = false;
+
+	size_t Written = 0;
+	while (Done && Written < Data.size()) {
+		DWORD Count = 0;
+		DWORD ChunkSize = (DWORD)min(Data.size() - Written, (size_t)1 << 30);
+
+		if (!WriteFile(FileHandle, Data.data() + Written, ChunkSize, &Count, NULL))
+			Done = false;
+
+		Written += Count;
 	}
 
-	cout << "Are you Sure you want perform this transaction? y/n ? ";
-	cin >> Answer;
+	if (Done && !FlushFileBuffers(FileHandle))
+		Done = false;
 
-	if (toupper(Answer) == 'Y') {
-		for (stClient& C : vClients) {
-			if (C.AccountNumber == AccountNumber) {
-				C.AccountBalance -= WithdrawAmount;
-				break;
-			}
-		}
-		SaveClientDataToFile(ClientFileName, vClients);
+	CloseHandle(FileHandle);
+#else
+	int FileDescriptor = open(FileName.c_str(), O_WRONLY | O_CREAT | (Append ? O_APPEND : O_TRUNC), 0644);
+	if (FileDescriptor < 0)
+		return false;
 
-		cout << "\n\nAmount Withdraw Successfully" << endl;
-		return true;
+	size_t Written = 0;
+	while (Done && Written < Data.size()) {
+		ssize_t Count = write(FileDescriptor, Data.data() + Written, Data.size() - Written);
+
+		if (Count < 0 && errno != EINTR)
+			Done = false;
+		else if (Count > 0)
+			Written += Count;
 	}
 
-	return false;
+	if (Done && fsync(FileDescriptor) != 0)
+		Done = false;
+
+	close(FileDescriptor);
+#endif
+
+	return Done;
 }
 
 /**
- * @brief Prints total balances report.
+ * @brief Replaces the content of a file so a crash never leaves it half written.
+ *
+ * The data is written and synced to FileName.tmp, which is then renamed
+ * over FileName. Until the rename the old file stays untouched, after
+ * it the new one is complete.
+ *
+ * @param FileName The file to replace.
+ * @param Data New content of the file.
+ * @return True if the file was replaced, false otherwise (the old file is kept).
  */
-void ShowTotalBalnces() {
-	vector <stClient> vClients;
-	vClients = LoadClientsDataFromFile(ClientFileName);
-	double TotalBalances = 0;
+bool ReplaceFileAtomically(const string& FileName, const string& Data) {
 
-	cout << "\n\t\t\t\t\tClient List (" << vClients.size() << ") Client(s).";
-	cout << "\n_______________________________________________________";
-	cout << "_________________________________________\n" << endl;
-	cout << "| " << left << setw(15) << "Accout Number";
-	cout << "| " << left << setw(40) << "Client Name";
-	cout << "| " << left << setw(12) << "Balance";
-	cout << "\n_______________________________________________________";
-	cout << "_________________________________________\n" << endl;
+	string TempFileName = FileName + ".tmp";
 
-	for (stClient& Client : vClients) {
-		PrintClientsDataForTotalBalances(Client);
-		TotalBalances += Client.AccountBalance;
-		cout << endl;
+	if (!WriteFileDurably(TempFileName, Data, false)) {
+		cerr << "Cannot write " << TempFileName << ", " << FileName << " is not saved." << endl;
+		remove(TempFileName.c_str());
+		return false;
 	}
 
-	cout << "\n_______________________________________________________";
-	cout << "_________________________________________\n" << endl;
+#ifdef _WIN32
+	if (!MoveFileExA(TempFileName.c_str(), FileName.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+		cerr << "Cannot replace " << FileName << "." << endl;
+		return false;
+	}
+#else
+	if (rename(TempFileName.c_str(), FileName.c_str()) != 0) {
+		cerr << "Cannot replace " << FileName << "." << endl;
+		return false;
+	}
+
+	size_t Slash = FileName.find_last_of('/');
+	string DirectoryName = (Slash == string::npos) ? "." : FileName.substr(0, Slash + 1);
+	int DirectoryDescriptor = open(DirectoryName.c_str(), O_RDONLY);
+
+	if (DirectoryDescriptor >= 0) {
+		fsync(DirectoryDescriptor);
+		close(DirectoryDescriptor);
+	}
+#endif
 
-	cout << "\t\t\t\tTotal Balances = " << TotalBalances;
+	return true;
 }
 
 /**
- * @brief Displays the "Delete Client" screen and handles client removal.
+ * @brief Appends a line of text to the end of a file.
  *
- * This function is responsible for the client deletion workflow. It first
- * checks whether the current user has the required permission to delete
- * clients (`pDeleteClient`). If access is denied, an error message is
- * displayed, and the user is redirected back to the main menu.
+ * This function opens a file in append mode and writes the given line
+ * followed by a newline character, then waits until it is on the disk.
+ * If the file cannot be opened, the function does nothing.
  *
- * If access is granted:
- *  - A header for the delete client screen is displayed.
- *  - The user is prompted to enter a client account number.
- *  - All client records are loaded from the file (`ClientFileName`).
- *  - The function `DeleteClientByAccountNumber()` is called to remove the
- *    client with the given account number.
+ * @param Line The text line to append to the file.
+ * @param FileName The name (or path) of the file to which the line will be written.
  */
-void ShowDeleteClientScreen() {
+void AddDataLineToFile(string Line, string FileName) {
 
-	if (!CheckAccessPermission(pDeleteClient)) {
-		ShowAccesDeniedMessage();
-		GoBackToMainMenu();
-		return;
+	WriteFileDurably(FileName, Line + "\n", true);
+}
+
+/**
+ * @brief Saves client data into file, replacing it atomically.
+ * @param FileName Target file.
+ * @param vClients Vector of clients.
+ * @return True if saved, false if the old file was kept.
+ */
+bool SaveClientDataToFile(string FileName, vector <stClient>& vClients) {
+
+	string Data;
+
+	for (stClient& C : vClients) {
+		if (C.MarkForDelete != true) {
+			Data += ConvertRecordToLine(C, "#//#");
+			Data += '\n';
+		}
 	}
 
-	cout << "\n---------------------------------------------------------------\n";
-	cout << "\t\tDelete Client Screen\n";
-	cout << "---------------------------------------------------------------\n";
+	return ReplaceFileAtomically(FileName, Data);
+}
 
-	string AccountNumber = ReadClientAccountNumber();
-	vector <stClient> vClients = LoadClientsDataFromFile(ClientFileName);
+/**
+ * @brief Saves user data into file, replacing it atomically.
+ * @param FileName Target file.
+ * @param vUsers Vector of users.
+ * @return True if saved, false if the old file was kept.
+ */
+bool SaveUserDataToFile(string FileName, vector <stUser>& vUsers) {
 
-	DeleteClientByAccountNumber(AccountNumber, vClients);
+	string Data;
+
+	for (stUser& U : vUsers) {
+		if (U.MarkForDelete != true) {
+			Data += ConvertRecordToLine(U, "#//#");
+			Data += '\n';
+		}
+	}
+
+	return ReplaceFileAtomically(FileName, Data);
 }
 
 /**
- * @brief Displays the "Delete User" screen and removes a user by username.
+ * @brief Computes the 64 bit FNV-1a hash of a block of bytes.
+ * @param Data Bytes to hash.
+ * @param Size Number of bytes.
+ * @return The hash.
+ */
+uint64_t ComputeChecksum(const char* Data, size_t Size) {
+
+	uint64_t Hash = 14695981039346656037ULL;
+
+	for (size_t i = 0; i < Size; i++) {
+		Hash ^= (unsigned char)Data[i];
+		Hash *= 1099511628211ULL;
+	}
+
+	return Hash;
+}
+
+/**
+ * @brief Saves client data into a binary snapshot file.
  *
- * This function handles the process of deleting a user from the system.
- * It provides a simple console interface to:
- *  - Display a header for the "Delete User" screen.
- *  - Prompt the administrator to enter the username of the account to be deleted.
- *  - Load the list of existing users from the file (`UserFileName`).
- *  - Call `DeleteUserByUsername()` to remove the specified user from the system.
+ * The whole snapshot is built in one buffer and written at once.
+ * Clients marked for delete are not written.
+ *
+ * @param FileName Target file.
+ * @param vClients Vector of clients.
+ * @return True if saved, false if the file could not be written.
  */
-void ShowDeleteUserScreen() {
+bool SaveClientDataToBinaryFile(string FileName, vector <stClient>& vClients) {
 
-	cout << "\n---------------------------------------------------------------\n";
-	cout << "\t\tDelete User Screen\n";
-	cout << "---------------------------------------------------------------\n";
+	vector <stBinaryClientRecord> vRecords;
+	string StringTable;
 
-	string UserName = "";
+	vRecords.reserve(vClients.size());
 
-	cout << "\nEnter Username? ";
-	cin >> UserName;
+	for (stClient& C : vClients) {
+		if (C.MarkForDelete == true)
+			continue;
+
+		stBinaryClientRecord Record;
+		const string* Fields[4] = { &C.AccountNumber, &C.PinCode, &C.FullName, &C.PhoneNumber };
 
-	vector <stUser> vUsers = LoadUsersDataFromFile(UserFileName);
+		Record.StringsOffset = StringTable.size();
+		for (int i = 0; i < 4; i++) {
+			Record.FieldLength[i] = (uint32_t)Fields[i]->size();
+			StringTable += *Fields[i];
+		}
+		Record.AccountBalance = C.AccountBalance;
+
+		vRecords.push_back(Record);
+	}
+
+	size_t RecordsSize = vRecords.size() * sizeof(stBinaryClientRecord);
+	string Buffer(sizeof(stBinarySnapshotHeader) + RecordsSize + StringTable.size(), '\0');
+	char* Body = &Buffer[sizeof(stBinarySnapshotHeader)];
 
-	DeleteUserByUsername(UserName, vUsers);
+	if (RecordsSize != 0)
+		memcpy(Body, vRecords.data(), RecordsSize);
+	memcpy(Body + RecordsSize, StringTable.data(), StringTable.size());
+
+	stBinarySnapshotHeader Header;
+	memcpy(Header.Magic, BinarySnapshotMagic, sizeof(Header.Magic));
+	Header.Version = BinarySnapshotVersion;
+	Header.RecordCount = vRecords.size();
+	Header.StringTableSize = StringTable.size();
+	Header.Checksum = ComputeChecksum(Body, RecordsSize + StringTable.size());
+	memcpy(&Buffer[0], &Header, sizeof(Header));
+
+	return ReplaceFileAtomically(FileName, Buffer);
 }
 
 /**
- * @brief Displays the "Add New Clients" screen and handles client creation.
+ * @brief Loads all clients from a binary snapshot file.
  *
- * This function provides a console interface for adding new clients to the system.
- * It performs the following steps:
- *  - Checks if the current user has the `pAddNewClients` permission.
- *    - If not, shows an "Access Denied" message and returns to the main menu.
- *  - Displays a formatted header for the "Add New Clients" screen.
- *  - Calls `AddClient()` to handle the actual client input and storage.
+ * The file is mapped into memory and checked against its header
+ * (magic, version, sizes and checksum) before any record is read.
+ *
+ * @param FileName The file to read from.
+ * @param vClients Output vector of clients.
+ * @return True if loaded, false if the file is missing or not a valid snapshot.
  */
-void ShowAddNewClientScreen() {
+bool LoadClientsDataFromBinaryFile(string FileName, vector <stClient>& vClients) {
+
+	stMappedFile MyFile;
+	stBinarySnapshotHeader Header;
+	bool Loaded = false;
+
+	vClients.clear();
+
+	if (OpenMappedFile(FileName, MyFile) && MyFile.Size >= sizeof(Header)) {
+		memcpy(&Header, MyFile.Data, sizeof(Header));
+
+		const char* Body = MyFile.Data + sizeof(Header);
+		size_t BodySize = MyFile.Size - sizeof(Header);
+		size_t RecordsSize = (size_t)Header.RecordCount * sizeof(stBinaryClientRecord);
+
+		if (memcmp(Header.Magic, BinarySnapshotMagic, sizeof(Header.Magic)) != 0)
+			cerr << "Error: " << FileName << " is not a clients snapshot.\n";
+		else if (Header.Version != 1 && Header.Version != BinarySnapshotVersion)
+			cerr << "Error: " << FileName << " has unsupported version " << Header.Version << ".\n";
+		else if (Header.RecordCount > BodySize / sizeof(stBinaryClientRecord) || RecordsSize + Header.StringTableSize != BodySize)
+			cerr << "Error: " << FileName << " is truncated.\n";
+		else if (ComputeChecksum(Body, BodySize) != Header.Checksum)
+			cerr << "Error: " << FileName << " checksum does not match.\n";
+		else {
+			const char* Strings = Body + RecordsSize;
+			stBinaryClientRecord Record;
+			Loaded = true;
+
+			vClients.resize((size_t)Header.RecordCount);
+
+			for (size_t i = 0; i < vClients.size(); i++) {
+				memcpy(&Record, Body + i * sizeof(Record), sizeof(Record));
+
+				uint64_t Offset = Record.StringsOffset;
+				uint64_t Length = (uint64_t)Record.FieldLength[0] + Record.FieldLength[1] + Record.FieldLength[2] + Record.FieldLength[3];
+
+				if (Offset > Header.StringTableSize || Length > Header.StringTableSize - Offset) {
+					cerr << "Error: " << FileName << " record " << i + 1 << " points outside the string table.\n";
+					vClients.clear();
+					Loaded = false;
+					break;
+				}
 
-	if (!CheckAccessPermission(pAddNewClients)) {
-		ShowAccesDeniedMessage();
-		GoBackToMainMenu();
-		return;
+				stClient& Client = vClients[i];
+				string* Fields[4] = { &Client.AccountNumber, &Client.PinCode, &Client.FullName, &Client.PhoneNumber };
+
+				for (int f = 0; f < 4; f++) {
+					Fields[f]->assign(Strings + Offset, Record.FieldLength[f]);
+					Offset += Record.FieldLength[f];
+				}
+				if (Header.Version == 1) {
+					double OldBalance;
+					memcpy(&OldBalance, &Record.AccountBalance, sizeof(OldBalance));
+					Client.AccountBalance = llround(OldBalance * 100);
+				}
+				else
+					Client.AccountBalance = Record.AccountBalance;
+			}
+		}
 	}
 
-	cout << "\n---------------------------------------------------------------\n";
-	cout << "\t\tAdd New Clients Screen\n";
-	cout << "---------------------------------------------------------------\n\n";
+	CloseMappedFile(MyFile);
+	return Loaded;
+}
 
-	AddClient();
+/**
+ * @brief Rebuilds the account number index of the clients repository.
+ *
+ * Clients marked for delete are left out of the index.
+ */
+void BuildAccountNumberIndex() {
+
+	ClientsRepository.AccountNumberIndex.clear();
+	ClientsRepository.AccountNumberIndex.reserve(ClientsRepository.vClients.size());
+
+	for (size_t i = 0; i < ClientsRepository.vClients.size(); i++) {
+		if (ClientsRepository.vClients[i].MarkForDelete != true)
+			ClientsRepository.AccountNumberIndex[ClientsRepository.vClients[i].AccountNumber] = i;
+	}
 }
 
-void ShowAddNewUserScreen() {
-	cout << "\n---------------------------------------------------------------\n";
-	cout << "\t\tAdd New Users Screen\n";
-	cout << "---------------------------------------------------------------\n\n";
+/**
+ * @brief Gets the id of an interned client name, interning it if needed.
+ * @param FullName Client name.
+ * @return Name id in ClientsRepository.Columns.vNames.
+ */
+uint32_t InternClientName(const string& FullName) {
 
-	AddUser();
+	stClientsColumns& Columns = ClientsRepository.Columns;
+	auto It = Columns.NameIds.find(FullName);
+
+	if (It != Columns.NameIds.end())
+		return It->second;
+
+	uint32_t NameId = (uint32_t)Columns.vNames.size();
+	Columns.vNames.push_back(FullName);
+	Columns.NameIds[FullName] = NameId;
+
+	return NameId;
 }
 
-void ShowUpdateClientInfoScreen() {
+/**
+ * @brief Gets the position of a stored client in the repository.
+ * @param Client Client stored in ClientsRepository.vClients.
+ * @return Its position.
+ */
+size_t GetClientPosition(const stClient& Client) {
 
-	if (!CheckAccessPermission(pFindClient)) {
-		ShowAccesDeniedMessage();
-		GoBackToMainMenu();
-		return;
-	}
+	return (size_t)(&Client - ClientsRepository.vClients.data());
+}
+
+/**
+ * @brief Gets the histogram bucket of a balance.
+ * @param Balance Balance in cents.
+ * @return Bucket index, from 0 to BalanceBucketCount - 1.
+ */
+int GetBalanceBucket(Money Balance) {
+
+	int Bucket = 0;
+
+	while (Bucket < BalanceBucketCount - 1 && Balance >= BalanceBucketLimits[Bucket])
+		Bucket++;
+
+	return Bucket;
+}
+
+/**
+ * @brief Lowers an atomic value to Value if Value is smaller.
+ */
+void StoreMinimum(atomic <Money>& Target, Money Value) {
+
+	Money Current = Target.load();
+
+	while (Value < Current && !Target.compare_exchange_weak(Current, Value)) {}
+}
+
+/**
+ * @brief Raises an atomic value to Value if Value is larger.
+ */
+void StoreMaximum(atomic <Money>& Target, Money Value) {
+
+	Money Current = Target.load();
+
+	while (Value > Current && !Target.compare_exchange_weak(Current, Value)) {}
+}
+
+/**
+ * @brief Empties the running totals of the clients repository.
+ */
+void ResetRunningTotals() {
+
+	stRunningTotals& Totals = ClientsRepository.Totals;
+
+	Totals.ClientCount = 0;
+	Totals.TotalBalances = 0;
+	Totals.MinBalance = 0;
+	Totals.MaxBalance = 0;
+	Totals.MinMaxStale = false;
+
+	for (atomic <size_t>& Bucket : Totals.vBuckets)
+		Bucket = 0;
+}
+
+/**
+ * @brief Counts a new active balance in the running totals. Rows are
+ *        only added while ClientsMutex is held alone.
+ * @param Balance Balance in cents.
+ */
+void AddToRunningTotals(Money Balance) {
+
+	stRunningTotals& Totals = ClientsRepository.Totals;
+
+	if (Totals.ClientCount++ == 0) {
+		Totals.MinBalance = Balance;
+		Totals.MaxBalance = Balance;
+	}
+	else {
+		StoreMinimum(Totals.MinBalance, Balance);
+		StoreMaximum(Totals.MaxBalance, Balance);
+	}
+
+	Totals.TotalBalances += Balance;
+	Totals.vBuckets[GetBalanceBucket(Balance)]++;
+}
+
+/**
+ * @brief Takes an active balance out of the running totals. Rows are
+ *        only removed while ClientsMutex is held alone.
+ * @param Balance Balance in cents.
+ */
+void RemoveFromRunningTotals(Money Balance) {
+
+	stRunningTotals& Totals = ClientsRepository.Totals;
+
+	Totals.ClientCount--;
+	Totals.TotalBalances -= Balance;
+	Totals.vBuckets[GetBalanceBucket(Balance)]--;
+
+	if (Balance == Totals.MinBalance || Balance == Totals.MaxBalance)
+		Totals.MinMaxStale = true;
+}
+
+/**
+ * @brief Moves an active balance in the running totals.
+ * @param OldBalance Balance before the change.
+ * @param NewBalance Balance after the change.
+ */
+void MoveInRunningTotals(Money OldBalance, Money NewBalance) {
+
+	stRunningTotals& Totals = ClientsRepository.Totals;
+	int OldBucket = GetBalanceBucket(OldBalance);
+	int NewBucket = GetBalanceBucket(NewBalance);
+
+	Totals.TotalBalances += NewBalance - OldBalance;
+
+	if (OldBucket != NewBucket) {
+		Totals.vBuckets[OldBucket]--;
+		Totals.vBuckets[NewBucket]++;
+	}
+
+	StoreMinimum(Totals.MinBalance, NewBalance);
+	StoreMaximum(Totals.MaxBalance, NewBalance);
+
+	if ((OldBalance == Totals.MinBalance && NewBalance > OldBalance) || (OldBalance == Totals.MaxBalance && NewBalance < OldBalance))
+		Totals.MinMaxStale = true;
+}
+
+/**
+ * @brief Copies the balance of a stored client into the balance column.
+ *
+ * Only touches the client's own row, so workers owning different
+ * clients may call it at the same time.
+ *
+ * @param Client Client stored in ClientsRepository.vClients.
+ */
+void UpdateBalanceColumn(const stClient& Client) {
+
+	if (Client.MarkForDelete != true) {
+		Money& Balance = ClientsRepository.Columns.vBalances[GetClientPosition(Client)];
+
+		MoveInRunningTotals(Balance, Client.AccountBalance);
+		Balance = Client.AccountBalance;
+	}
+}
+
+/**
+ * @brief Converts text to lowercase, for case-insensitive name keys.
+ * @param Text The text.
+ * @return Lowercase copy of the text.
+ */
+string ConvertToLowerCase(string_view Text) {
+
+	string Lower(Text);
+
+	for (char& C : Lower)
+		C = (char)tolower((unsigned char)C);
+
+	return Lower;
+}
+
+/**
+ * @brief Checks, ignoring case, if a text contains a lowercase search text.
+ * @param Text The text to search in.
+ * @param LowerSearch Lowercase text to search for.
+ * @return True if found, false otherwise.
+ */
+bool ContainsIgnoringCase(string_view Text, string_view LowerSearch) {
+
+	auto It = search(Text.begin(), Text.end(), LowerSearch.begin(), LowerSearch.end(),
+		[](char A, char B) { return tolower((unsigned char)A) == B; });
+
+	return It != Text.end() || LowerSearch.empty();
+}
+
+/**
+ * @brief Packs three characters of a lowercase name into a trigram key.
+ * @param Text At least three characters.
+ * @return Trigram key.
+ */
+uint32_t GetTrigram(const char* Text) {
+
+	return ((uint32_t)(unsigned char)Text[0] << 16) | ((uint32_t)(unsigned char)Text[1] << 8) | (unsigned char)Text[2];
+}
+
+/**
+ * @brief Adds a row to the name index.
+ *
+ * Trigrams the row already had under its previous name are already in
+ * their lists, the others are inserted in row order.
+ *
+ * @param Position Row of the client.
+ * @param FullName New name of the client.
+ * @param PreviousName Name the row had before, empty for a new row.
+ */
+void AddToNameIndex(size_t Position, const string& FullName, const string& PreviousName) {
+
+	stClientNameIndex& NameIndex = ClientsRepository.NameIndex;
+	string LowerName = ConvertToLowerCase(FullName);
+	string LowerPreviousName = ConvertToLowerCase(PreviousName);
+
+	for (size_t i = 0; i + 3 <= LowerName.size(); i++) {
+		if (LowerPreviousName.find(string_view(LowerName).substr(i, 3)) != string::npos)
+			continue;
+
+		vector <uint32_t>& vRows = NameIndex.Trigrams[GetTrigram(&LowerName[i])];
+		auto It = lower_bound(vRows.begin(), vRows.end(), (uint32_t)Position);
+
+		if (It == vRows.end() || *It != Position)
+			vRows.insert(It, (uint32_t)Position);
+	}
+
+	NameIndex.Sorted.emplace(move(LowerName), Position);
+}
+
+/**
+ * @brief Removes a row from the name index.
+ *
+ * Trigrams the row keeps under its next name stay in their lists, the
+ * others lose the row, so renames do not grow the lists.
+ *
+ * @param Position Row of the client.
+ * @param FullName Name the row is indexed under.
+ * @param NextName Name the row gets next, empty when it leaves the index.
+ */
+void RemoveFromNameIndex(size_t Position, const string& FullName, const string& NextName) {
+
+	stClientNameIndex& NameIndex = ClientsRepository.NameIndex;
+	string LowerName = ConvertToLowerCase(FullName);
+	string LowerNextName = ConvertToLowerCase(NextName);
+
+	for (size_t i = 0; i + 3 <= LowerName.size(); i++) {
+		if (LowerNextName.find(string_view(LowerName).substr(i, 3)) != string::npos)
+			continue;
+
+		auto List = NameIndex.Trigrams.find(GetTrigram(&LowerName[i]));
+
+		if (List == NameIndex.Trigrams.end())
+			continue;
+
+		vector <uint32_t>& vRows = List->second;
+		auto It = lower_bound(vRows.begin(), vRows.end(), (uint32_t)Position);
+
+		if (It != vRows.end() && *It == Position)
+			vRows.erase(It);
+
+		if (vRows.empty())
+			NameIndex.Trigrams.erase(List);
+	}
+
+	auto Range = NameIndex.Sorted.equal_range(LowerName);
+
+	for (auto It = Range.first; It != Range.second; ++It) {
+		if (It->second == Position) {
+			NameIndex.Sorted.erase(It);
+			return;
+		}
+	}
+}
+
+/**
+ * @brief Searches the active clients by name, ignoring case.
+ *
+ * A prefix search walks the sorted index from the first name not below
+ * the prefix, so its results come sorted by name. A contains search
+ * reads the shortest trigram list of the search text and checks each
+ * row, its results come in row order. Texts under three characters are
+ * checked against every name.
+ *
+ * @param Text Text to search for.
+ * @param Mode enNamePrefix or enNameContains.
+ * @param MaxResults Most results to return.
+ * @return Rows of the matching clients.
+ */
+vector <size_t> SearchClientsByName(string_view Text, enNameSearchMode Mode, size_t MaxResults) {
+
+	stClientNameIndex& NameIndex = ClientsRepository.NameIndex;
+	stClientsColumns& Columns = ClientsRepository.Columns;
+	string LowerText = ConvertToLowerCase(Text);
+	vector <size_t> vPositions;
+
+	if (Mode == enNamePrefix) {
+		for (auto It = NameIndex.Sorted.lower_bound(LowerText); It != NameIndex.Sorted.end() && vPositions.size() < MaxResults; ++It) {
+			if (It->first.compare(0, LowerText.size(), LowerText) != 0)
+				break;
+			vPositions.push_back(It->second);
+		}
+
+		return vPositions;
+	}
+
+	auto Matches = [&](size_t Position) {
+		return Columns.vIsActive[Position] == 1 && ContainsIgnoringCase(Columns.vNames[Columns.vNameIds[Position]], LowerText);
+	};
+
+	vector <uint32_t> vCandidates;
+
+	if (LowerText.size() < 3) {
+		vCandidates.resize(Columns.vIsActive.size());
+		for (size_t Position = 0; Position < vCandidates.size(); Position++)
+			vCandidates[Position] = (uint32_t)Position;
+	}
+	else {
+		const vector <uint32_t>* Shortest = nullptr;
+
+		for (size_t i = 0; i + 3 <= LowerText.size(); i++) {
+			auto It = NameIndex.Trigrams.find(GetTrigram(&LowerText[i]));
+
+			if (It == NameIndex.Trigrams.end())
+				return vPositions;
+
+			if (Shortest == nullptr || It->second.size() < Shortest->size())
+				Shortest = &It->second;
+		}
+
+		vCandidates = *Shortest;
+		sort(vCandidates.begin(), vCandidates.end());
+		vCandidates.erase(unique(vCandidates.begin(), vCandidates.end()), vCandidates.end());
+	}
+
+	for (size_t i = 0; i < vCandidates.size() && vPositions.size() < MaxResults; i++) {
+		if (Matches(vCandidates[i]))
+			vPositions.push_back(vCandidates[i]);
+	}
+
+	return vPositions;
+}
+
+/**
+ * @brief Normalizes a phone number to its digits, so "0770 79-16 60"
+ *        and "0770791660" find the same client.
+ * @param PhoneNumber Phone number as typed.
+ * @return The digits of the phone number.
+ */
+string NormalizePhoneNumber(string_view PhoneNumber) {
+
+	string Digits;
+
+	for (char C : PhoneNumber) {
+		if (isdigit((unsigned char)C))
+			Digits += C;
+	}
+
+	return Digits;
+}
+
+/**
+ * @brief Moves a row of the phone index to the phone number of its client.
+ * @param Position Row of the client.
+ * @param Client Client stored at the row.
+ */
+void UpdatePhoneIndex(size_t Position, const stClient& Client) {
+
+	stClientPhoneIndex& PhoneIndex = ClientsRepository.PhoneIndex;
+
+	if (Position == PhoneIndex.vKeys.size())
+		PhoneIndex.vKeys.emplace_back();
+
+	string& Key = PhoneIndex.vKeys[Position];
+
+	if (!Key.empty()) {
+		vector <size_t>& vPositions = PhoneIndex.Positions[Key];
+
+		vPositions.erase(remove(vPositions.begin(), vPositions.end(), Position), vPositions.end());
+		if (vPositions.empty())
+			PhoneIndex.Positions.erase(Key);
+	}
+
+	Key = (Client.MarkForDelete != true) ? NormalizePhoneNumber(Client.PhoneNumber) : "";
+
+	if (!Key.empty())
+		PhoneIndex.Positions[Key].push_back(Position);
+}
+
+/**
+ * @brief Copies a stored client into its row of the columns, the name
+ *        index, the phone index and the running totals, adding the row
+ *        if the client was just appended.
+ * @param Client Client stored in ClientsRepository.vClients.
+ */
+void UpdateClientColumns(const stClient& Client) {
+
+	stClientsColumns& Columns = ClientsRepository.Columns;
+	size_t Position = GetClientPosition(Client);
+	bool IsNewRow = (Position == Columns.vBalances.size());
+
+	if (IsNewRow) {
+		Columns.vBalances.push_back(0);
+		Columns.vIsActive.push_back(0);
+		Columns.vNameIds.push_back(0);
+	}
+
+	bool WasActive = !IsNewRow && Columns.vIsActive[Position] == 1;
+	bool IsActive = (Client.MarkForDelete != true);
+	string PreviousName = WasActive ? Columns.vNames[Columns.vNameIds[Position]] : "";
+
+	if (WasActive)
+		RemoveFromRunningTotals(Columns.vBalances[Position]);
+	if (IsActive)
+		AddToRunningTotals(Client.AccountBalance);
+
+	Columns.vBalances[Position] = IsActive ? Client.AccountBalance : 0;
+	Columns.vIsActive[Position] = IsActive ? 1 : 0;
+	Columns.vNameIds[Position] = InternClientName(Client.FullName);
+
+	if (WasActive)
+		RemoveFromNameIndex(Position, PreviousName, IsActive ? Client.FullName : "");
+	if (IsActive)
+		AddToNameIndex(Position, Client.FullName, PreviousName);
+
+	UpdatePhoneIndex(Position, Client);
+}
+
+/**
+ * @brief Rebuilds the columns, the secondary indexes and the running totals of the clients repository from vClients.
+ */
+void BuildClientsColumns() {
+
+	stClientsColumns& Columns = ClientsRepository.Columns;
+
+	Columns = stClientsColumns();
+	ResetRunningTotals();
+	ClientsRepository.NameIndex = stClientNameIndex();
+	ClientsRepository.PhoneIndex = stClientPhoneIndex();
+	Columns.vBalances.reserve(ClientsRepository.vClients.size());
+	Columns.vIsActive.reserve(ClientsRepository.vClients.size());
+	Columns.vNameIds.reserve(ClientsRepository.vClients.size());
+
+	for (stClient& C : ClientsRepository.vClients)
+		UpdateClientColumns(C);
+}
+
+/**
+ * @brief Sums a block of balances using SIMD registers when available.
+ * @param Balances First balance.
+ * @param Count Number of balances.
+ * @return The sum.
+ */
+Money SumBalances(const Money* Balances, size_t Count) {
+
+	size_t i = 0;
+	Money Total = 0;
+
+#if defined(__AVX2__)
+	__m256i Sum0 = _mm256_setzero_si256();
+	__m256i Sum1 = _mm256_setzero_si256();
+
+	for (; i + 8 <= Count; i += 8) {
+		Sum0 = _mm256_add_epi64(Sum0, _mm256_loadu_si256((const __m256i*)(Balances + i)));
+		Sum1 = _mm256_add_epi64(Sum1, _mm256_loadu_si256((const __m256i*)(Balances + i + 4)));
+	}
+
+	int64_t Lanes[4];
+	_mm256_storeu_si256((__m256i*)Lanes, _mm256_add_epi64(Sum0, Sum1));
+	Total = Lanes[0] + Lanes[1] + Lanes[2] + Lanes[3];
+#elif defined(BANK_USE_SSE2)
+	__m128i Sum0 = _mm_setzero_si128();
+	__m128i Sum1 = _mm_setzero_si128();
+
+	for (; i + 4 <= Count; i += 4) {
+		Sum0 = _mm_add_epi64(Sum0, _mm_loadu_si128((const __m128i*)(Balances + i)));
+		Sum1 = _mm_add_epi64(Sum1, _mm_loadu_si128((const __m128i*)(Balances + i + 2)));
+	}
+
+	int64_t Lanes[2];
+	_mm_storeu_si128((__m128i*)Lanes, _mm_add_epi64(Sum0, Sum1));
+	Total = Lanes[0] + Lanes[1];
+#endif
+
+	for (; i < Count; i++)
+		Total += Balances[i];
+
+	return Total;
+}
+
+/**
+ * @brief Scans a range of rows of the balance column.
+ * @param Begin First row.
+ * @param End Row after the last one.
+ * @return Count, total, min, max and histogram of the active rows.
+ */
+stBalanceSummary ScanBalanceColumn(size_t Begin, size_t End) {
+
+	const stClientsColumns& Columns = ClientsRepository.Columns;
+	stBalanceSummary Summary;
+
+	Summary.TotalBalances = SumBalances(Columns.vBalances.data() + Begin, End - Begin);
+
+	for (size_t i = Begin; i < End; i++) {
+		if (Columns.vIsActive[i] == 0)
+			continue;
+
+		Money Balance = Columns.vBalances[i];
+
+		if (Summary.ClientCount == 0 || Balance < Summary.MinBalance)
+			Summary.MinBalance = Balance;
+		if (Summary.ClientCount == 0 || Balance > Summary.MaxBalance)
+			Summary.MaxBalance = Balance;
+
+		Summary.ClientCount++;
+		Summary.vBuckets[GetBalanceBucket(Balance)]++;
+	}
+
+	return Summary;
+}
+
+/**
+ * @brief Gets the label of a histogram bucket, like "1000.00 - 9999.99".
+ * @param Bucket Bucket index.
+ * @return Bucket label.
+ */
+string GetBalanceBucketLabel(int Bucket) {
+
+	if (Bucket == 0)
+		return "below " + FormatMoney(BalanceBucketLimits[0]);
+	if (Bucket == BalanceBucketCount - 1)
+		return FormatMoney(BalanceBucketLimits[Bucket - 1]) + " and above";
+
+	return FormatMoney(BalanceBucketLimits[Bucket - 1]) + " - " + FormatMoney(BalanceBucketLimits[Bucket] - 1);
+}
+
+/**
+ * @brief Copies the running totals into a summary.
+ * @return The summary, min and max as last counted.
+ */
+stBalanceSummary CopyRunningTotals() {
+
+	stRunningTotals& Totals = ClientsRepository.Totals;
+	stBalanceSummary Summary;
+
+	Summary.ClientCount = Totals.ClientCount;
+	Summary.TotalBalances = Totals.TotalBalances;
+	Summary.MinBalance = Totals.MinBalance;
+	Summary.MaxBalance = Totals.MaxBalance;
+
+	for (int Bucket = 0; Bucket < BalanceBucketCount; Bucket++)
+		Summary.vBuckets[Bucket] = Totals.vBuckets[Bucket];
+
+	return Summary;
+}
+
+/**
+ * @brief Gets the totals of the active balances without a scan.
+ *
+ * Only when the min or the max went stale are the balances scanned
+ * again, holding ClientsMutex alone so none of them moves meanwhile.
+ *
+ * @return Count, total, min, max and histogram of the active balances.
+ */
+stBalanceSummary GetRunningTotals() {
+
+	{
+		shared_lock <shared_mutex> Lock(ClientsMutex);
+
+		if (!ClientsRepository.Totals.MinMaxStale)
+			return CopyRunningTotals();
+	}
+
+	lock_guard <shared_mutex> Lock(ClientsMutex);
+
+	if (ClientsRepository.Totals.MinMaxStale) {
+		stBalanceSummary Summary = ScanBalanceColumn(0, ClientsRepository.Columns.vBalances.size());
+
+		ClientsRepository.Totals.MinBalance = Summary.MinBalance;
+		ClientsRepository.Totals.MaxBalance = Summary.MaxBalance;
+		ClientsRepository.Totals.MinMaxStale = false;
+	}
+
+	return CopyRunningTotals();
+}
+
+/**
+ * @brief Recounts the totals with a full scan and checks the running
+ *        totals against it, correcting them if they differ.
+ * @param Summary Output totals of the full scan.
+ * @return True if the running totals matched, false otherwise.
+ */
+bool VerifyRunningTotals(stBalanceSummary& Summary) {
+
+	lock_guard <shared_mutex> Lock(ClientsMutex);
+
+	stRunningTotals& Totals = ClientsRepository.Totals;
+
+	Summary = ScanBalanceColumn(0, ClientsRepository.Columns.vBalances.size());
+
+	bool Match = Totals.ClientCount == Summary.ClientCount && Totals.TotalBalances == Summary.TotalBalances;
+	Match = Match && (Totals.MinMaxStale || (Totals.MinBalance == Summary.MinBalance && Totals.MaxBalance == Summary.MaxBalance));
+
+	for (int Bucket = 0; Bucket < BalanceBucketCount; Bucket++)
+		Match = Match && Totals.vBuckets[Bucket] == Summary.vBuckets[Bucket];
+
+	if (!Match) {
+		Totals.ClientCount = Summary.ClientCount;
+		Totals.TotalBalances = Summary.TotalBalances;
+		for (int Bucket = 0; Bucket < BalanceBucketCount; Bucket++)
+			Totals.vBuckets[Bucket] = Summary.vBuckets[Bucket];
+	}
+
+	Totals.MinBalance = Summary.MinBalance;
+	Totals.MaxBalance = Summary.MaxBalance;
+	Totals.MinMaxStale = false;
+
+	return Match;
+}
+
+/**
+ * @brief Gets a client stored in the repository by account number.
+ *
+ * The compactor erases rows and rebuilds the index under an exclusive
+ * ClientsMutex, so callers hold ClientsMutex for as long as they use the
+ * pointer, or run while loading, before any other thread starts.
+ *
+ * @param AccountNumber Account number.
+ * @return Pointer to the stored client, or nullptr if not found.
+ */
+stClient* GetClientByAccountNumber(const string& AccountNumber) {
+
+	auto It = ClientsRepository.AccountNumberIndex.find(AccountNumber);
+
+	if (It == ClientsRepository.AccountNumberIndex.end())
+		return nullptr;
+
+	return &ClientsRepository.vClients[It->second];
+}
+
+/**
+ * @brief Gets the stripe of AccountLocks an account belongs to.
+ * @param AccountNumber Account number.
+ * @return Index in AccountLocks, always the same one for an account.
+ */
+size_t GetAccountLockStripe(const string& AccountNumber) {
+
+	return hash <string>()(AccountNumber) % AccountLockStripes;
+}
+
+/**
+ * @brief Gets the lock guarding the balance of an account.
+ * @param AccountNumber Account number.
+ * @return The stripe lock of the account, always the same one for an account.
+ */
+mutex& GetAccountLock(const string& AccountNumber) {
+
+	return AccountLocks[GetAccountLockStripe(AccountNumber)];
+}
+
+/**
+ * @brief Adds a client to the repository and its index.
+ * @param ClientData Client record.
+ */
+void AddClientToRepository(const stClient& ClientData) {
+
+	ClientsRepository.AccountNumberIndex[ClientData.AccountNumber] = ClientsRepository.vClients.size();
+	ClientsRepository.vClients.push_back(ClientData);
+	UpdateClientColumns(ClientsRepository.vClients.back());
+}
+
+/**
+ * @brief Gets the current time for the account history.
+ * @return Seconds since 1970-01-01 UTC.
+ */
+int64_t GetHistoryTime() {
+
+	return (int64_t)time(nullptr);
+}
+
+/**
+ * @brief Formats a history time as local date and time.
+ * @param Time Seconds since 1970-01-01 UTC.
+ * @return Time as YYYY-MM-DD HH:MM:SS.
+ */
+string FormatHistoryTime(int64_t Time) {
+
+	time_t Value = (time_t)Time;
+	tm LocalTime = {};
+	char Text[32];
+
+#ifdef _WIN32
+	localtime_s(&LocalTime, &Value);
+#else
+	localtime_r(&Value, &LocalTime);
+#endif
+
+	strftime(Text, sizeof(Text), "%Y-%m-%d %H:%M:%S", &LocalTime);
+	return Text;
+}
+
+/**
+ * @brief Parses a date, YYYY-MM-DD, into the first or the last second of that local day.
+ * @param Text Date text.
+ * @param EndOfDay True for the last second of the day, false for the first.
+ * @param Time Output seconds since 1970-01-01 UTC.
+ * @return True if the text is a valid date, false otherwise.
+ */
+bool ParseHistoryDate(string_view Text, bool EndOfDay, int64_t& Time) {
+
+	tm LocalTime = {};
+	string Date(Text);
+
+	if (sscanf(Date.c_str(), "%4d-%2d-%2d", &LocalTime.tm_year, &LocalTime.tm_mon, &LocalTime.tm_mday) != 3)
+		return false;
+
+	LocalTime.tm_year -= 1900;
+	LocalTime.tm_mon -= 1;
+	LocalTime.tm_hour = EndOfDay ? 23 : 0;
+	LocalTime.tm_min = EndOfDay ? 59 : 0;
+	LocalTime.tm_sec = EndOfDay ? 59 : 0;
+	LocalTime.tm_isdst = -1;
+
+	time_t Value = mktime(&LocalTime);
+
+	if (Value == (time_t)-1)
+		return false;
+
+	Time = (int64_t)Value;
+	return true;
+}
+
+/**
+ * @brief Converts a history entry into a line of the history file.
+ * @param Entry History entry.
+ * @param Seprator Field separator.
+ * @return AccountNumber, Time, Type, Amount, Balance and Operator joined by Seprator.
+ */
+string ConvertHistoryEntryToLine(const stHistoryEntry& Entry, string Seprator) {
+
+	return Entry.AccountNumber + Seprator + to_string(Entry.Time) + Seprator + Entry.Type + Seprator
+		+ FormatMoney(Entry.Amount) + Seprator + FormatMoney(Entry.Balance) + Seprator + Entry.Operator;
+}
+
+/**
+ * @brief Converts a line of the history file into a history entry.
+ * @param Line History line.
+ * @param Entry Output history entry.
+ * @param Seperator Delimiter between fields.
+ * @return True if the line is valid, false otherwise.
+ */
+bool ConvertHistoryLineToEntry(string_view Line, stHistoryEntry& Entry, string_view Seperator = "#//#") {
+
+	string_view vEntry[6];
+
+	if (SplitLine(Line, Seperator, vEntry, 6) != 6 || vEntry[2].size() != 1)
+		return false;
+
+	if (!ParseNumberField(vEntry[1], Entry.Time) || !ParseMoney(vEntry[3], Entry.Amount) || !ParseMoney(vEntry[4], Entry.Balance))
+		return false;
+
+	Entry.AccountNumber.assign(vEntry[0]);
+	Entry.Type = vEntry[2][0];
+	Entry.Operator.assign(vEntry[5]);
+	return true;
+}
+
+/**
+ * @brief Adds an entry written at Offset of the history file to the
+ *        block index of its account. ClientHistory must be locked.
+ * @param AccountNumber Account of the entry.
+ * @param Time Time of the entry, not before the last entry of the account.
+ * @param Offset Offset of the entry line in the history file.
+ */
+void IndexHistoryEntry(const string& AccountNumber, int64_t Time, uint64_t Offset) {
+
+	vector <stHistoryBlock>& vBlocks = ClientHistory.Blocks[AccountNumber];
+
+	if (vBlocks.empty() || vBlocks.back().vOffsets.size() >= HistoryBlockSize) {
+		vBlocks.emplace_back();
+		vBlocks.back().FirstTime = Time;
+		vBlocks.back().vOffsets.reserve(HistoryBlockSize);
+	}
+
+	vBlocks.back().LastTime = Time;
+	vBlocks.back().vOffsets.push_back(Offset);
+}
+
+/**
+ * @brief Makes the history entry of a balance change that just happened.
+ * @param Client Client after the change.
+ * @param Type D, W or T.
+ * @param Amount Amount in cents, negative when money left the account.
+ * @return The entry, timed now.
+ */
+stHistoryEntry MakeHistoryEntry(const stClient& Client, char Type, Money Amount) {
+
+	stHistoryEntry Entry;
+
+	Entry.AccountNumber = Client.AccountNumber;
+	Entry.Time = GetHistoryTime();
+	Entry.Type = Type;
+	Entry.Amount = Amount;
+	Entry.Balance = Client.AccountBalance;
+	return Entry;
+}
+
+/**
+ * @brief Queues an entry for the history file and indexes it.
+ *
+ * The entry goes out with the next journal batch. Its time is moved up
+ * to the last entry of the account if the clock stepped back, so the
+ * blocks of an account stay in time order.
+ *
+ * @param Entry History entry, its operator is filled in from OperatorName when empty.
+ */
+void QueueHistoryEntry(stHistoryEntry Entry) {
+
+	if (Entry.Operator.empty())
+		Entry.Operator = OperatorName;
+
+	lock_guard <mutex> Lock(GroupCommit.Mutex);
+
+	auto It = ClientHistory.Blocks.find(Entry.AccountNumber);
+
+	if (It != ClientHistory.Blocks.end() && !It->second.empty())
+		Entry.Time = max(Entry.Time, It->second.back().LastTime);
+
+	string Line = ConvertHistoryEntryToLine(Entry, "#//#");
+
+	IndexHistoryEntry(Entry.AccountNumber, Entry.Time, ClientHistory.FileSize);
+	GroupCommit.PendingHistory += Line;
+	GroupCommit.PendingHistory += '\n';
+	ClientHistory.FileSize += Line.size() + 1;
+}
+
+/**
+ * @brief Writes the queued history entries to the history file.
+ *        JournalMutex must be locked, so entries are written in order.
+ */
+void WritePendingHistory() {
+
+	string Entries;
+
+	{
+		lock_guard <mutex> Lock(GroupCommit.Mutex);
+		Entries.swap(GroupCommit.PendingHistory);
+	}
+
+	while (!Entries.empty() && !WriteFileDurably(ClientHistoryFileName, Entries, true)) {
+		cerr << "Cannot write " << ClientHistoryFileName << ", retrying." << endl;
+		this_thread::sleep_for(chrono::milliseconds(100));
+	}
+}
+
+/**
+ * @brief Builds the block index of the history file.
+ *
+ * Only the account and the time of each line are read. A last line
+ * cut by a crash gets its line end, so the next entry starts on its own line.
+ */
+void LoadClientHistory() {
+
+	stMappedFile MyFile;
+
+	ClientHistory = stClientHistory();
+
+	if (OpenMappedFile(ClientHistoryFileName, MyFile)) {
+		ForEachLine(MyFile, [&](string_view Line, size_t LineNumber) {
+			string_view vEntry[6];
+			int64_t Time = 0;
+
+			if (SplitLine(Line, "#//#", vEntry, 6) != 6 || !ParseNumberField(vEntry[1], Time)) {
+				ReportMalformedLine(ClientHistoryFileName, LineNumber);
+				return;
+			}
+
+			IndexHistoryEntry(string(vEntry[0]), Time, (uint64_t)(Line.data() - MyFile.Data));
+		});
+
+		ClientHistory.FileSize = MyFile.Size;
+
+		if (MyFile.Size != 0 && MyFile.Data[MyFile.Size - 1] != '\n' && WriteFileDurably(ClientHistoryFileName, "\n", true))
+			ClientHistory.FileSize++;
+	}
+
+	CloseMappedFile(MyFile);
+}
+
+/**
+ * @brief Reads history entries at the given offsets of the history file.
+ * @param vOffsets Offsets of the entry lines.
+ * @return The entries that could be read, in the order of vOffsets.
+ */
+vector <stHistoryEntry> ReadHistoryEntries(const vector <uint64_t>& vOffsets) {
+
+	vector <stHistoryEntry> vEntries;
+	ifstream MyFile(ClientHistoryFileName, ios::in | ios::binary);
+	string Line;
+
+	for (uint64_t Offset : vOffsets) {
+		stHistoryEntry Entry;
+
+		MyFile.clear();
+		MyFile.seekg((streamoff)Offset);
+
+		if (getline(MyFile, Line) && ConvertHistoryLineToEntry(TrimLineEnd(Line), Entry))
+			vEntries.push_back(move(Entry));
+	}
+
+	return vEntries;
+}
+
+/**
+ * @brief Gets the last transactions of an account, walking its blocks from the newest.
+ * @param AccountNumber Account number.
+ * @param Count Most entries to return.
+ * @return The entries, oldest first.
+ */
+vector <stHistoryEntry> GetLastHistoryEntries(const string& AccountNumber, size_t Count) {
+
+	vector <uint64_t> vOffsets;
+
+	{
+		lock_guard <mutex> Lock(GroupCommit.Mutex);
+
+		auto It = ClientHistory.Blocks.find(AccountNumber);
+
+		if (It != ClientHistory.Blocks.end()) {
+			for (auto Block = It->second.rbegin(); Block != It->second.rend() && vOffsets.size() < Count; ++Block) {
+				for (auto Offset = Block->vOffsets.rbegin(); Offset != Block->vOffsets.rend() && vOffsets.size() < Count; ++Offset)
+					vOffsets.push_back(*Offset);
+			}
+		}
+	}
+
+	reverse(vOffsets.begin(), vOffsets.end());
+	return ReadHistoryEntries(vOffsets);
+}
+
+/**
+ * @brief Gets the statement of an account for a time range.
+ *
+ * The blocks of an account are in time order, so the first block that
+ * reaches From is found by binary search and only the blocks up to To
+ * are read.
+ *
+ * @param AccountNumber Account number.
+ * @param From First second of the range.
+ * @param To Last second of the range.
+ * @return The entries in the range, oldest first.
+ */
+vector <stHistoryEntry> GetHistoryStatement(const string& AccountNumber, int64_t From, int64_t To) {
+
+	vector <uint64_t> vOffsets;
+
+	{
+		lock_guard <mutex> Lock(GroupCommit.Mutex);
+
+		auto It = ClientHistory.Blocks.find(AccountNumber);
+
+		if (It != ClientHistory.Blocks.end()) {
+			vector <stHistoryBlock>& vBlocks = It->second;
+			auto Block = partition_point(vBlocks.begin(), vBlocks.end(), [From](const stHistoryBlock& B) { return B.LastTime < From; });
+
+			for (; Block != vBlocks.end() && Block->FirstTime <= To; ++Block)
+				vOffsets.insert(vOffsets.end(), Block->vOffsets.begin(), Block->vOffsets.end());
+		}
+	}
+
+	vector <stHistoryEntry> vEntries = ReadHistoryEntries(vOffsets);
+
+	vEntries.erase(remove_if(vEntries.begin(), vEntries.end(),
+		[From, To](const stHistoryEntry& E) { return E.Time < From || E.Time > To; }), vEntries.end());
+
+	return vEntries;
+}
+
+/**
+ * @brief Writes the pending journal records in batches until none is left.
+ *
+ * Runs on its own thread, started by the first record queued while it
+ * is not running. Each batch costs one write and one sync.
+ */
+void RunGroupCommitFlusher() {
+
+	while (true) {
+		{
+			unique_lock <mutex> Lock(GroupCommit.Mutex);
+
+			if (GroupCommit.PendingCount == 0) {
+				GroupCommit.FlusherRunning = false;
+				GroupCommit.FlusherStopped.notify_all();
+				return;
+			}
+
+			GroupCommit.BatchReady.wait_until(Lock, GroupCommit.BatchOpened + chrono::milliseconds(GroupCommitWindowMilliseconds),
+				[] { return GroupCommit.Stopping || GroupCommit.PendingCount == 0 || GroupCommit.PendingCount >= GroupCommitMaxRecords; });
+		}
+
+		string Records;
+		uint64_t Batch = 0;
+
+		{
+			lock_guard <mutex> FileLock(JournalMutex);
+
+			{
+				lock_guard <mutex> Lock(GroupCommit.Mutex);
+				Records.swap(GroupCommit.PendingRecords);
+				GroupCommit.PendingCount = 0;
+				Batch = GroupCommit.OpenBatch++;
+			}
+
+			WritePendingHistory();
+
+			while (!Records.empty() && !WriteFileDurably(GetClientJournalFileName(), Records, true)) {
+				cerr << "Cannot write " << GetClientJournalFileName() << ", retrying." << endl;
+				this_thread::sleep_for(chrono::milliseconds(100));
+			}
+		}
+
+		{
+			lock_guard <mutex> Lock(GroupCommit.Mutex);
+			GroupCommit.DurableBatch = max(GroupCommit.DurableBatch, Batch);
+		}
+
+		GroupCommit.BatchDurable.notify_all();
+	}
+}
+
+/**
+ * @brief Queues a record for the journal.
+ *
+ * The record is not on the disk yet: the caller must release its locks
+ * and then call WaitForJournalBatch before acknowledging the change.
+ * Records are written in the order they are queued.
+ *
+ * @param Record Journal line, without the line end.
+ * @param CompactionDue Output, true if the journal is due for compaction.
+ * @return The batch the record went into.
+ */
+uint64_t AppendRecordToJournal(const string& Record, bool& CompactionDue) {
+
+	lock_guard <mutex> Lock(GroupCommit.Mutex);
+
+	if (GroupCommit.PendingCount == 0)
+		GroupCommit.BatchOpened = chrono::steady_clock::now();
+
+	GroupCommit.PendingRecords += Record;
+	GroupCommit.PendingRecords += '\n';
+	GroupCommit.PendingCount++;
+
+	if (!GroupCommit.FlusherRunning) {
+		GroupCommit.FlusherRunning = true;
+		thread(RunGroupCommitFlusher).detach();
+	}
+	else if (GroupCommit.PendingCount >= GroupCommitMaxRecords)
+		GroupCommit.BatchReady.notify_one();
+
+	ClientsRepository.JournalRecords++;
+	CompactionDue = ClientsRepository.JournalRecords >= JournalCompactionThreshold;
+
+	return GroupCommit.OpenBatch;
+}
+
+/**
+ * @brief Waits until a journal batch is on the disk.
+ * @param Batch Batch returned by AppendRecordToJournal.
+ */
+void WaitForJournalBatch(uint64_t Batch) {
+
+	unique_lock <mutex> Lock(GroupCommit.Mutex);
+	GroupCommit.BatchDurable.wait(Lock, [Batch] { return GroupCommit.DurableBatch >= Batch; });
+}
+
+/**
+ * @brief Writes the last journal batch without waiting for the commit
+ *        window and waits for the flusher thread to stop.
+ *
+ * Called before the program exits, when nothing queues records anymore.
+ */
+void FlushGroupCommitAndStop() {
+
+	{
+		unique_lock <mutex> Lock(GroupCommit.Mutex);
+
+		GroupCommit.Stopping = true;
+		GroupCommit.BatchReady.notify_one();
+		GroupCommit.FlusherStopped.wait(Lock, [] { return !GroupCommit.FlusherRunning; });
+	}
+
+	lock_guard <mutex> FileLock(JournalMutex);
+	WritePendingHistory();
+}
+
+/**
+ * @brief Empties the journal once a snapshot holds every change.
+ *
+ * Records still waiting for their batch are in the snapshot too, so
+ * they are dropped and their callers acknowledged.
+ */
+void TruncateClientJournal() {
+
+	lock_guard <mutex> FileLock(JournalMutex);
+
+	WritePendingHistory();
+	WriteFileDurably(GetClientJournalFileName(), "", false);
+
+	{
+		lock_guard <mutex> Lock(GroupCommit.Mutex);
+
+		if (GroupCommit.PendingCount > 0) {
+			GroupCommit.PendingRecords.clear();
+			GroupCommit.PendingCount = 0;
+			GroupCommit.DurableBatch = GroupCommit.OpenBatch++;
+		}
+	}
+
+	GroupCommit.BatchDurable.notify_all();
+}
+
+/**
+ * @brief Saves the clients repository to the clients file, or to the
+ *        binary snapshot when UseBinarySnapshot is set.
+ *
+ * The saved file is a full snapshot, so the journal is emptied right
+ * after it. If the snapshot cannot be saved the journal is kept, so no
+ * change is lost. Clients marked for delete are not written, and are
+ * dropped from memory once the file is saved.
+ *
+ * @return True if saved, false if the file could not be written.
+ */
+bool SaveClientsRepository() {
+
+	bool Saved = UseBinarySnapshot
+		? SaveClientDataToBinaryFile(ClientBinaryFileName, ClientsRepository.vClients)
+		: SaveClientDataToFile(ClientFileName, ClientsRepository.vClients);
+
+	if (!Saved)
+		return false;
+
+	TruncateClientJournal();
+	ClientsRepository.JournalRecords = 0;
+
+	size_t Count = ClientsRepository.vClients.size();
+	ClientsRepository.vClients.erase(
+		remove_if(ClientsRepository.vClients.begin(), ClientsRepository.vClients.end(),
+			[](const stClient& C) { return C.MarkForDelete; }),
+		ClientsRepository.vClients.end());
+
+	ClientsRepository.DeletedClients = 0;
+
+	if (Count != ClientsRepository.vClients.size()) {
+		BuildAccountNumberIndex();
+		BuildClientsColumns();
+	}
+
+	return true;
+}
+
+/**
+ * @brief Converts a client balance into a journal line.
+ * @param ClientData Client data.
+ * @param Seprator Field separator.
+ * @return String line for the journal file.
+ */
+string ConvertBalanceToJournalLine(const stClient& ClientData, string Seprator) {
+
+	return "B" + Seprator + ClientData.AccountNumber + Seprator + FormatMoney(ClientData.AccountBalance);
+}
+
+/**
+ * @brief Converts a whole client record into a journal line.
+ * @param ClientData Client data.
+ * @param Seprator Field separator.
+ * @return String line for the journal file.
+ */
+string ConvertClientToJournalLine(stClient& ClientData, string Seprator) {
+
+	return "C" + Seprator + ConvertRecordToLine(ClientData, Seprator);
+}
+
+/**
+ * @brief Converts a transfer into a journal line holding both resulting balances.
+ * @param FromClient Client the money left.
+ * @param ToClient Client the money went to.
+ * @param Seprator Field separator.
+ * @return String line for the journal file.
+ */
+string ConvertTransferToJournalLine(const stClient& FromClient, const stClient& ToClient, string Seprator) {
+
+	return "T" + Seprator + FromClient.AccountNumber + Seprator + FormatMoney(FromClient.AccountBalance)
+		+ Seprator + ToClient.AccountNumber + Seprator + FormatMoney(ToClient.AccountBalance);
+}
+
+/**
+ * @brief Converts a client delete into a journal line.
+ * @param AccountNumber Account number of the deleted client.
+ * @param Seprator Field separator.
+ * @return String line for the journal file.
+ */
+string ConvertDeleteToJournalLine(const string& AccountNumber, string Seprator) {
+
+	return "X" + Seprator + AccountNumber;
+}
+
+/**
+ * @brief Folds the journal back into the clients file if it is still due.
+ *
+ * Takes ClientsMutex alone, so it must be called once the balance
+ * change that filled the journal has released its locks.
+ */
+void CompactClientJournal() {
+
+	lock_guard <shared_mutex> Lock(ClientsMutex);
+
+	if (ClientsRepository.JournalRecords >= JournalCompactionThreshold)
+		SaveClientsRepository();
+}
+
+/**
+ * @brief Replays a balance record (B#//#AccountNumber#//#Balance) of the journal.
+ * @param Record Journal line.
+ * @return True if the record is valid, false otherwise.
+ */
+bool ReplayBalanceRecord(string_view Record) {
+
+	string_view vRecord[3];
+	Money AccountBalance = 0;
+
+	if (SplitLine(Record, "#//#", vRecord, 3) != 3 || vRecord[0] != "B" || !ParseMoney(vRecord[2], AccountBalance))
+		return false;
+
+	stClient* Client = GetClientByAccountNumber(string(vRecord[1]));
+	if (Client != nullptr)
+		Client->AccountBalance = AccountBalance;
+
+	return true;
+}
+
+/**
+ * @brief Replays a client record (C#//# followed by a client line) of the
+ *        journal, adding the client or replacing it.
+ * @param Record Journal line.
+ * @return True if the record is valid, false otherwise.
+ */
+bool ReplayClientRecord(string_view Record) {
+
+	stClient ClientData;
+
+	if (!ConvertClientsLineDataToRecord(Record.substr(strlen("C#//#")), ClientData))
+		return false;
+
+	stClient* Client = GetClientByAccountNumber(ClientData.AccountNumber);
+
+	if (Client != nullptr)
+		*Client = ClientData;
+	else {
+		ClientsRepository.AccountNumberIndex[ClientData.AccountNumber] = ClientsRepository.vClients.size();
+		ClientsRepository.vClients.push_back(ClientData);
+	}
+
+	return true;
+}
+
+/**
+ * @brief Replays a transfer record (T#//#From#//#FromBalance#//#To#//#ToBalance)
+ *        of the journal. The record holds both balances, so a transfer is
+ *        replayed whole or, if its line was cut, not at all.
+ * @param Record Journal line.
+ * @return True if the record is valid, false otherwise.
+ */
+bool ReplayTransferRecord(string_view Record) {
+
+	string_view vRecord[5];
+	Money FromBalance = 0, ToBalance = 0;
+
+	if (SplitLine(Record, "#//#", vRecord, 5) != 5 || vRecord[0] != "T"
+		|| !ParseMoney(vRecord[2], FromBalance) || !ParseMoney(vRecord[4], ToBalance))
+		return false;
+
+	stClient* FromClient = GetClientByAccountNumber(string(vRecord[1]));
+	if (FromClient != nullptr)
+		FromClient->AccountBalance = FromBalance;
+
+	stClient* ToClient = GetClientByAccountNumber(string(vRecord[3]));
+	if (ToClient != nullptr)
+		ToClient->AccountBalance = ToBalance;
+
+	return true;
+}
+
+/**
+ * @brief Replays a delete record (X#//#AccountNumber) of the journal.
+ *        Deletes of unknown accounts are skipped.
+ * @param Record Journal line.
+ * @return True if the record is valid, false otherwise.
+ */
+bool ReplayDeleteRecord(string_view Record) {
+
+	string_view vRecord[2];
+
+	if (SplitLine(Record, "#//#", vRecord, 2) != 2 || vRecord[0] != "X")
+		return false;
+
+	string AccountNumber(vRecord[1]);
+	stClient* Client = GetClientByAccountNumber(AccountNumber);
+
+	if (Client != nullptr) {
+		Client->MarkForDelete = true;
+		ClientsRepository.AccountNumberIndex.erase(AccountNumber);
+		ClientsRepository.DeletedClients++;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Replays the journal on top of the loaded clients.
+ *
+ * Journal records hold the resulting balance or the whole client, not
+ * the amount, so replaying a record that is already in the clients file
+ * is harmless. Balance records for unknown accounts are skipped.
+ *
+ * @param FileName The journal file to read from.
+ */
+void ReplayClientJournal(string FileName) {
+
+	fstream MyFile;
+	MyFile.open(FileName, ios::in);
+
+	if (MyFile.is_open()) {
+		string Line;
+		size_t LineNumber = 0;
+
+		while (getline(MyFile, Line)) {
+			LineNumber++;
+			string_view Record = TrimLineEnd(Line);
+			string_view Key = GetRecordKey(Record);
+			bool Replayed = (Key == "C") ? ReplayClientRecord(Record)
+				: (Key == "X") ? ReplayDeleteRecord(Record)
+				: (Key == "T") ? ReplayTransferRecord(Record)
+				: ReplayBalanceRecord(Record);
+
+			if (!Replayed) {
+				ReportMalformedLine(FileName, LineNumber);
+				continue;
+			}
+
+			ClientsRepository.JournalRecords++;
+		}
+
+		MyFile.close();
+	}
+}
+
+/**
+ * @brief Loads all clients from file into the clients repository.
+ *
+ * Called once at startup, every screen then works on the repository
+ * instead of reading the file again. Clients are read from the binary
+ * snapshot when UseBinarySnapshot is set. The journal of that file is
+ * replayed on top of the loaded clients.
+ *
+ * A missing or empty text file is a new, empty store. A text file with
+ * data but no readable client fails the load, so it is never saved over.
+ *
+ * @return False if the binary snapshot is missing or invalid, or the
+ *         text file cannot be read, true otherwise.
+ */
+bool LoadClientsRepository() {
+
+	bool Loaded = true;
+
+	if (UseBinarySnapshot)
+		Loaded = LoadClientsDataFromBinaryFile(ClientBinaryFileName, ClientsRepository.vClients);
+	else {
+		error_code Error;
+		ClientsRepository.vClients = LoadClientsDataFromFile(ClientFileName);
+		uintmax_t FileSize = filesystem::file_size(ClientFileName, Error);
+		Loaded = !ClientsRepository.vClients.empty() || Error || FileSize == 0;
+	}
+	ClientsRepository.JournalRecords = 0;
+	ClientsRepository.DeletedClients = 0;
+	BuildAccountNumberIndex();
+	ReplayClientJournal(GetClientJournalFileName());
+	BuildClientsColumns();
+
+	return Loaded;
+}
+
+/**
+ * @brief Converts the text clients file into a binary snapshot.
+ *
+ * The text journal is replayed first, so the snapshot holds every
+ * change. The binary journal is emptied, its records are older than the
+ * new snapshot.
+ *
+ * @return True if converted, false otherwise.
+ */
+bool ExportClientsToBinaryFile() {
+
+	UseBinarySnapshot = false;
+
+	if (!LoadClientsRepository()) {
+		cerr << "Error: cannot read " << ClientFileName << ".\n";
+		return false;
+	}
+
+	if (!SaveClientDataToBinaryFile(ClientBinaryFileName, ClientsRepository.vClients)
+		|| !WriteFileDurably(ClientBinaryJournalFileName, "", false)) {
+		cerr << "Error: cannot write " << ClientBinaryFileName << ".\n";
+		return false;
+	}
+
+	cout << "Exported " << ClientsRepository.vClients.size() - ClientsRepository.DeletedClients << " client(s) from "
+		<< ClientFileName << " to " << ClientBinaryFileName << ".\n";
+	return true;
+}
+
+/**
+ * @brief Converts a binary snapshot back into the text clients file.
+ *
+ * The binary journal is replayed first, so the text file holds every
+ * change. The text journal is emptied, its records are older than the
+ * new file.
+ *
+ * @return True if converted, false otherwise.
+ */
+bool ImportClientsFromBinaryFile() {
+
+	UseBinarySnapshot = true;
+
+	if (!LoadClientsRepository())
+		return false;
+
+	if (!SaveClientDataToFile(ClientFileName, ClientsRepository.vClients)
+		|| !WriteFileDurably(ClientJournalFileName, "", false)) {
+		cerr << "Error: cannot write " << ClientFileName << ".\n";
+		return false;
+	}
+
+	cout << "Imported " << ClientsRepository.vClients.size() - ClientsRepository.DeletedClients << " client(s) from "
+		<< ClientBinaryFileName << " to " << ClientFileName << ".\n";
+	return true;
+}
+
+/**
+ * @brief Maps the users file and finds its lines. The users are parsed
+ *        by the first caller that needs one, see ParsePendingUsers.
+ * @return False if the file holds no line, as nobody could log in, true otherwise.
+ */
+bool LoadUsersRepository() {
+
+	CloseLazyRecordsFile(PendingUsersFile);
+	OpenLazyRecordsFile(UserFileName, PendingUsersFile);
+	UsersRepository.vUsers.clear();
+	UsersRepository.UserNameIndex.clear();
+	UsersRepository.DeletedUsers = 0;
+	UsersRepository.LinesPending = true;
+	VerifiedSessions.clear();
+	SessionDigestKey = GenerateRandomBytes(32);
+
+	return !PendingUsersFile.vLines.empty();
+}
+
+/**
+ * @brief Saves the users repository to the users file.
+ *
+ * The saved file holds every delete, so the user journal is emptied
+ * right after it. Users marked for delete are not written, and are
+ * dropped from memory once the file is saved.
+ */
+void SaveUsersRepository() {
+
+	if (!SaveUserDataToFile(UserFileName, UsersRepository.vUsers))
+		return;
+
+	WriteFileDurably(UserJournalFileName, "", false);
+	UsersRepository.DeletedUsers = 0;
+
+	size_t Count = UsersRepository.vUsers.size();
+	UsersRepository.vUsers.erase(
+		remove_if(UsersRepository.vUsers.begin(), UsersRepository.vUsers.end(),
+			[](const stUser& U) { return U.MarkForDelete; }),
+		UsersRepository.vUsers.end());
+
+	if (Count != UsersRepository.vUsers.size())
+		BuildUserNameIndex();
+}
+
+/**
+ * @brief Checks if the tombstones of a store are worth a rewrite.
+ * @param DeletedRows Rows marked for delete.
+ * @param Rows All rows, deleted ones included.
+ * @return True once the garbage crosses the compaction threshold.
+ */
+bool IsGarbageCompactionDue(size_t DeletedRows, size_t Rows) {
+
+	return DeletedRows > 0 && (DeletedRows * 100 >= Rows * GarbageCompactionPercent || DeletedRows >= GarbageCompactionMaxRows);
+}
+
+/**
+ * @brief Rewrites the clients and users files that are due, until no
+ *        more compaction is requested.
+ *
+ * Runs on its own thread, started by ScheduleGarbageCompaction, so the
+ * delete that crossed the threshold does not wait for the rewrite.
+ */
+void RunGarbageCompactor() {
+
+	while (true) {
+		{
+			lock_guard <shared_mutex> Lock(ClientsMutex);
+
+			if (ClientsRepository.JournalRecords >= JournalCompactionThreshold
+				|| IsGarbageCompactionDue(ClientsRepository.DeletedClients, ClientsRepository.vClients.size()))
+				SaveClientsRepository();
+		}
+
+		{
+			lock_guard <mutex> Lock(UsersMutex);
+
+			if (IsGarbageCompactionDue(UsersRepository.DeletedUsers, UsersRepository.vUsers.size()))
+				SaveUsersRepository();
+		}
+
+		lock_guard <mutex> Lock(Compactor.Mutex);
+
+		if (!Compactor.Requested) {
+			Compactor.Running = false;
+			Compactor.Stopped.notify_all();
+			return;
+		}
+
+		Compactor.Requested = false;
+	}
+}
+
+/**
+ * @brief Starts the background compactor, or asks the running one for another pass.
+ */
+void ScheduleGarbageCompaction() {
+
+	lock_guard <mutex> Lock(Compactor.Mutex);
+
+	if (Compactor.Running) {
+		Compactor.Requested = true;
+		return;
+	}
+
+	Compactor.Running = true;
+	thread(RunGarbageCompactor).detach();
+}
+
+/**
+ * @brief Waits until the background compactor is done, so the program
+ *        does not exit while it is rewriting a file.
+ */
+void WaitForGarbageCompactor() {
+
+	unique_lock <mutex> Lock(Compactor.Mutex);
+	Compactor.Stopped.wait(Lock, [] { return !Compactor.Running; });
+}
+
+/**
+ * @brief Gets a user stored in the users repository by username.
+ * @param UserName Username.
+ * @return Pointer to the stored user, or nullptr if not found.
+ */
+stUser* GetUserByUserName(const string& UserName) {
+
+	auto It = UsersRepository.UserNameIndex.find(UserName);
+
+	if (It == UsersRepository.UserNameIndex.end())
+		return nullptr;
+
+	return &UsersRepository.vUsers[It->second];
+}
+
+/**
+ * @brief Computes the fast digest a verified session keeps of a password.
+ * @param UserName Username.
+ * @param Password The password.
+ * @return Digest keyed with SessionDigestKey, which never leaves the process.
+ */
+string ComputeSessionDigest(const string& UserName, const string& Password) {
+
+	return ComputeSha256(SessionDigestKey + UserName + '\0' + Password);
+}
+
+/**
+ * @brief Gets a password hash that belongs to no user, checked against
+ *        when the username is unknown.
+ * @return The hash, made once with the current PasswordHashIterations.
+ */
+const string& GetDummyPasswordHash() {
+
+	static const string DummyPasswordHash = HashPassword(GenerateRandomBytes(16));
+
+	return DummyPasswordHash;
+}
+
+/**
+ * @brief Checks a username and password and gets the user.
+ *
+ * A login that matches a verified session of the last VerifiedSessionSeconds
+ * only costs one SHA-256. Any other attempt pays the full password hash,
+ * which runs outside UsersMutex so other callers are not held up. An
+ * unknown username pays it too, against a dummy hash, so the response
+ * time does not tell which usernames exist. A legacy plaintext password
+ * is replaced by its hash once it is verified.
+ *
+ * @param UserName Username.
+ * @param Password Password.
+ * @param User Output user, set only on success.
+ * @return True if the credentials are valid, false otherwise.
+ */
+bool AuthenticateUser(const string& UserName, const string& Password, stUser& User) {
+
+	string StoredPassword = GetDummyPasswordHash();
+	bool UserFound = false;
+	string SessionDigest = ComputeSessionDigest(UserName, Password);
+	chrono::steady_clock::time_point Now = chrono::steady_clock::now();
+
+	{
+		lock_guard <mutex> Lock(UsersMutex);
+		ParsePendingUsers();
+
+		stUser* StoredUser = GetUserByUserName(UserName);
+
+		if (StoredUser != nullptr) {
+			UserFound = true;
+			StoredPassword = StoredUser->Password;
+		}
+
+		auto Session = VerifiedSessions.find(UserName);
+
+		if (UserFound && Session != VerifiedSessions.end() && Session->second.Expires > Now
+			&& Session->second.StoredPassword == StoredPassword
+			&& EqualInConstantTime(Session->second.PasswordDigest, SessionDigest)) {
+			User = *StoredUser;
+			return true;
+		}
+	}
+
+	bool PasswordMatches = VerifyPassword(StoredPassword, Password);
+
+	if (!UserFound || !PasswordMatches)
+		return false;
+
+	string NewStoredPassword = IsPasswordHashed(StoredPassword) ? StoredPassword : HashPassword(Password);
+
+	lock_guard <mutex> Lock(UsersMutex);
+
+	stUser* StoredUser = GetUserByUserName(UserName);
+
+	if (StoredUser == nullptr || StoredUser->Password != StoredPassword)
+		return false;
+
+	StoredUser->Password = NewStoredPassword;
+	User = *StoredUser;
+
+	if (NewStoredPassword != StoredPassword)
+		SaveUsersRepository();
+
+	stVerifiedSession& Session = VerifiedSessions[UserName];
+	Session.StoredPassword = NewStoredPassword;
+	Session.PasswordDigest = SessionDigest;
+	Session.Expires = Now + chrono::seconds(VerifiedSessionSeconds);
+
+	return true;
+}
+
+/**
+ * @brief Checks if an account number already exists.
+ * @param AccountNumber The account number to check.
+ * @return True if exists, false otherwise.
+ */
+bool CheckAccountNumberExist(string AccountNumber) {
+
+	bool Exists = false;
+	{
+		shared_lock <shared_mutex> Lock(ClientsMutex);
+		Exists = GetClientByAccountNumber(AccountNumber) != nullptr;
+	}
+
+	if (Exists) {
+		cout << "Client With [" << AccountNumber << "] already exists, Enter another Account Number? ";
+		return true;
+	}
+	return false;
+}
+
+/**
+ * @brief Checks if a given username already exists in the users database.
+ *
+ * This function looks the username up in the users repository index.
+ *
+ * @param UserName The username to check for existence.
+ * @return True if the username already exists, otherwise false.
+ */
+bool CheckUserNameExist(string UserName) {
+	lock_guard <mutex> Lock(UsersMutex);
+	ParsePendingUsers();
+
+	if (GetUserByUserName(UserName) != nullptr) {
+		cout << "User With [" << UserName << "] already exists, Enter another UserName? ";
+		return true;
+	}
+	return false;
+}
+
+/**
+ * @brief Searches for a user by username in the users database.
+ *
+ * This function looks the username up in the users repository index.
+ * If a match is found, the user is copied into the output parameter.
+ *
+ * @param UserName The username to search for.
+ * @param User Reference to a stUser object where the found user data will be stored.
+ * @return True if the user was found, otherwise false.
+ */
+bool FindUserByUserName(string UserName, stUser& User) {
+
+	lock_guard <mutex> Lock(UsersMutex);
+	ParsePendingUsers();
+
+	stUser* StoredUser = GetUserByUserName(UserName);
+
+	if (StoredUser == nullptr)
+		return false;
+
+	User = *StoredUser;
+	return true;
+}
+
+/**
+ * @brief Reads client data from user input.
+ * @param ClientData Reference to stClient.
+ * @return Filled client record.
+ */
+stClient ReadClientData(stClient& ClientData) {
+
+	cout << "Enter Account Number? ";
+	do {
+		getline(cin >> ws, ClientData.AccountNumber);
+	} while (CheckAccountNumberExist(ClientData.AccountNumber));
+
+	cout << "Enter PinCode? ";
+	getline(cin, ClientData.PinCode);
+
+	cout << "Enter Name? ";
+	getline(cin, ClientData.FullName);
+
+	cout << "Enter Phone? ";
+	getline(cin, ClientData.PhoneNumber);
+
+	cout << "Enter AccountBalance? ";
+	ClientData.AccountBalance = ReadMoney();
+
+	return ClientData;
+}
+
+/**
+ * @brief Asks for one of the named roles.
+ * @return Number of the chosen role in Roles, starting at 1, or 0 to choose permissions one by one.
+ */
+short ReadRole() {
+
+	short Role = -1;
+
+	cout << "\nChoose a role:\n";
+	for (short i = 0; i < RoleCount; i++)
+		cout << "\t[" << i + 1 << "] " << Roles[i].Name << "\n";
+	cout << "\t[0] Custom permissions\n";
+
+	do {
+		cout << "Role? [0 to " << RoleCount << "]? ";
+		cin >> Role;
+
+		if (cin.fail() && !cin.eof()) {
+			cin.clear();
+			cin.ignore(numeric_limits<streamsize>::max(), '\n');
+		}
+	} while (cin && (Role < 0 || Role > RoleCount));
+
+	return cin ? Role : 0;
+}
+
+/**
+ * @brief Reads and assigns access permissions for a user.
+ *
+ * This function interacts with the console to configure a user's permissions.
+ * It first checks if the user should have full access (all permissions).
+ * If not, it offers the named roles, then asks for specific permissions
+ * one by one.
+ *
+ * Permissions are represented as integer flags (bitmask).
+ * - If full access is granted, the function returns -1 (special flag for all permissions).
+ * - Otherwise, the function ORs the selected permission bits together.
+ *`
+ *
+ * @return An integer representing the user's granted permissions.
+ */
+int ReadPermissions() {
+	char Answer = 'n';
+	int Permissions = 0;
+
+	do {
+		cout << "\nDo you want to give full access? Y/N? ";
+		cin >> Answer;
+	} while (toupper(Answer) != 'Y' && toupper(Answer) != 'N');
+
+	if (toupper(Answer) == 'Y')
+		return -1;
+
+	short Role = ReadRole();
+
+	if (Role != 0)
+		return Roles[Role - 1].Permissions;
+
+	cout << "\nDo you want to give to? \n";
+
+	cout << "\nShow Client List? y/n? ";
+	cin >> Answer;
+	if (toupper(Answer) == 'Y')
+		Permissions |= pListClients;
+
+	cout << "\nAdd New Client? y/n? ";
+	cin >> Answer;
+	if (toupper(Answer) == 'Y')
+		Permissions |= pAddNewClients;
+
+	cout << "\nDelete Client? y/n? ";
+	cin >> Answer;
+	if (toupper(Answer) == 'Y')
+		Permissions |= pDeleteClient;
+
+	cout << "\nUpdate Client? y/n? ";
+	cin >> Answer;
+	if (toupper(Answer) == 'Y')
+		Permissions |= pUpdateClient;
+
+	cout << "\nFind Client? y/n? ";
+	cin >> Answer;
+	if (toupper(Answer) == 'Y')
+		Permissions |= pFindClient;
+
+	cout << "\nTransactions? y/n? ";
+	cin >> Answer;
+	if (toupper(Answer) == 'Y')
+		Permissions |= pTransactions;
+
+	cout << "\nmanage Users? y/n? ";
+	cin >> Answer;
+	if (toupper(Answer) == 'Y')
+		Permissions |= pManageUsers;
+
+	return Permissions;
+}
+
+/**
+ * @brief Reads user data from user input.
+ * @param User Reference to stUser.
+ * @return Filled user record.
+ */
+stUser ReadUserData(stUser& User) {
+
+	cout << "Enter UserName? ";
+	do {
+		getline(cin >> ws, User.UserName);
+	} while (CheckUserNameExist(User.UserName));
+
+	cout << "Enter Password? ";
+	getline(cin, User.Password);
+
+	User.Permissions = ReadPermissions();
+
+	return User;
+}
+
+/**
+ * @brief Reads an account number from user input.
+ * @return Account number.
+ */
+string ReadClientAccountNumber() {
+	string AccountNumber;
+
+	cout << "\nPlease Enter Account Number? ";
+	cin >> AccountNumber;
+
+	return AccountNumber;
+}
+
+/**
+ * @brief Finds a client by account number.
+ * @param AccountNumber Account number.
+ * @param Client Output client.
+ * @return True if found, false otherwise.
+ */
+bool FindClientByAccountNumber(const string& AccountNumber, stClient& Client) {
+
+	shared_lock <shared_mutex> RepositoryLock(ClientsMutex);
+
+	stClient* StoredClient = GetClientByAccountNumber(AccountNumber);
+
+	if (StoredClient == nullptr)
+		return false;
+
+	lock_guard <mutex> AccountLock(GetAccountLock(AccountNumber));
+
+	Client = *StoredClient;
+	return true;
+}
+
+/**
+ * @brief Finds clients by name, ignoring case.
+ * @param Text Text to search for.
+ * @param Mode enNamePrefix or enNameContains.
+ * @return Copies of the matching clients, at most MaxSearchResults.
+ */
+vector <stClient> FindClientsByName(string_view Text, enNameSearchMode Mode) {
+
+	shared_lock <shared_mutex> Lock(ClientsMutex);
+
+	vector <stClient> vClients;
+
+	for (size_t Position : SearchClientsByName(Text, Mode, MaxSearchResults))
+		vClients.push_back(ClientsRepository.vClients[Position]);
+
+	return vClients;
+}
+
+/**
+ * @brief Finds the clients holding a phone number.
+ * @param PhoneNumber Phone number, separators are ignored.
+ * @return Copies of the matching clients.
+ */
+vector <stClient> FindClientsByPhoneNumber(string_view PhoneNumber) {
+
+	shared_lock <shared_mutex> Lock(ClientsMutex);
+
+	vector <stClient> vClients;
+	auto It = ClientsRepository.PhoneIndex.Positions.find(NormalizePhoneNumber(PhoneNumber));
+
+	if (It != ClientsRepository.PhoneIndex.Positions.end()) {
+		for (size_t Position : It->second)
+			vClients.push_back(ClientsRepository.vClients[Position]);
+	}
+
+	return vClients;
+}
+
+/**
+ * @brief Loads user information based on username and password.
+ *
+ * This function attempts to find a user in the system using the provided
+ * username and password. If a matching user is found, the user's details
+ * are loaded into the global variable `CurrentUser`.
+ *
+ * @param UserName The username to search for.
+ * @param Password The password to validate.
+ * @return True if the user was found and authenticated successfully,
+ *         otherwise false.
+ */
+bool LoadUserInfo(string UserName, string Password) {
+
+	if (AuthenticateUser(UserName, Password, CurrentUser)) {
+		CurrentRights = GetEffectiveRights(CurrentUser.Permissions);
+		OperatorName = CurrentUser.UserName;
+		return true;
+	}
+	else
+		return false;
+}
+
+/**
+ * @brief Marks a client for deletion by account number.
+ * @param AccountNumber Account number.
+ * @return True if marked, false otherwise.
+ */
+bool MarkClientForDeleteByAccountNumber(string AccountNumber) {
+
+	stClient* Client = GetClientByAccountNumber(AccountNumber);
+
+	if (Client == nullptr)
+		return false;
+
+	Client->MarkForDelete = true;
+	ClientsRepository.AccountNumberIndex.erase(AccountNumber);
+	ClientsRepository.DeletedClients++;
+	UpdateClientColumns(*Client);
+	return true;
+}
+
+/**
+ * @brief Marks a user for deletion by username.
+ * @param Username.
+ * @return True if marked, false otherwise.
+ */
+bool MarkUserForDeleteByUsername(string Username) {
+
+	stUser* User = GetUserByUserName(Username);
+
+	if (User == nullptr)
+		return false;
+
+	User->MarkForDelete = true;
+	UsersRepository.UserNameIndex.erase(Username);
+	UsersRepository.DeletedUsers++;
+	return true;
+}
+
+/**
+ * @brief Adds a new client to the repository and journals it.
+ * @param ClientData Client record.
+ * @return enStoreDone, or enStoreAlreadyExists if the account number is taken.
+ */
+enStoreResult AddClientToStore(stClient ClientData) {
+
+	uint64_t Batch = 0;
+
+	{
+		lock_guard <shared_mutex> Lock(ClientsMutex);
+
+		if (GetClientByAccountNumber(ClientData.AccountNumber) != nullptr)
+			return enStoreAlreadyExists;
+
+		AddClientToRepository(ClientData);
+
+		bool CompactJournal = false;
+		Batch = AppendRecordToJournal(ConvertClientToJournalLine(ClientData, "#//#"), CompactJournal);
+
+		if (CompactJournal && !SaveClientsRepository())
+			cerr << "Cannot compact the clients journal, the change stays in the journal." << endl;
+	}
+
+	WaitForJournalBatch(Batch);
+	return enStoreDone;
+}
+
+/**
+ * @brief Replaces the record of an existing client and journals it.
+ * @param ClientData New client record, found by its account number.
+ * @return enStoreDone, or enStoreNotFound.
+ */
+enStoreResult UpdateClientInStore(stClient ClientData) {
+
+	uint64_t Batch = 0;
+
+	{
+		lock_guard <shared_mutex> Lock(ClientsMutex);
+
+		stClient* StoredClient = GetClientByAccountNumber(ClientData.AccountNumber);
+
+		if (StoredClient == nullptr)
+			return enStoreNotFound;
+
+		*StoredClient = ClientData;
+		UpdateClientColumns(*StoredClient);
+
+		bool CompactJournal = false;
+		Batch = AppendRecordToJournal(ConvertClientToJournalLine(ClientData, "#//#"), CompactJournal);
+
+		if (CompactJournal && !SaveClientsRepository())
+			cerr << "Cannot compact the clients journal, the change stays in the journal." << endl;
+	}
+
+	WaitForJournalBatch(Batch);
+	return enStoreDone;
+}
+
+/**
+ * @brief Deletes a client and journals the delete.
+ *
+ * The client stays in memory as a tombstone, so a delete costs one
+ * journal record. The compactor drops the tombstones in the background
+ * once there are enough of them.
+ *
+ * @param AccountNumber Account number.
+ * @return enStoreDone, or enStoreNotFound.
+ */
+enStoreResult DeleteClientFromStore(string AccountNumber) {
+
+	uint64_t Batch = 0;
+
+	{
+		lock_guard <shared_mutex> Lock(ClientsMutex);
+
+		if (!MarkClientForDeleteByAccountNumber(AccountNumber))
+			return enStoreNotFound;
+
+		bool CompactJournal = false;
+		Batch = AppendRecordToJournal(ConvertDeleteToJournalLine(AccountNumber, "#//#"), CompactJournal);
+
+		if (CompactJournal || IsGarbageCompactionDue(ClientsRepository.DeletedClients, ClientsRepository.vClients.size()))
+			ScheduleGarbageCompaction();
+	}
+
+	WaitForJournalBatch(Batch);
+	return enStoreDone;
+}
+
+/**
+ * @brief Checks the overdraft rule: a withdraw cannot exceed the balance.
+ * @param Client Client record.
+ * @param WithdrawAmount Amount to withdraw in cents.
+ * @return True if the amount can be withdrawn, false otherwise.
+ */
+bool CanWithdraw(const stClient& Client, Money WithdrawAmount) {
+
+	return WithdrawAmount <= Client.AccountBalance;
+}
+
+/**
+ * @brief Changes the balance of a client and journals the new balance.
+ *
+ * Only the lock of the account is taken alone, so changes to accounts
+ * on other stripes run at the same time. Returns once the journal
+ * batch holding the change is on the disk.
+ *
+ * @param AccountNumber Account number.
+ * @param Amount Amount in cents, negative for a withdraw.
+ * @param NewBalance Output balance after the change.
+ * @return enStoreDone, enStoreNotFound or enStoreInsufficientFunds.
+ */
+enStoreResult ChangeClientBalance(const string& AccountNumber, Money Amount, Money& NewBalance) {
+
+	bool CompactJournal = false;
+	uint64_t Batch = 0;
+
+	{
+		shared_lock <shared_mutex> RepositoryLock(ClientsMutex);
+
+		stClient* Client = GetClientByAccountNumber(AccountNumber);
+
+		if (Client == nullptr)
+			return enStoreNotFound;
+
+		lock_guard <mutex> AccountLock(GetAccountLock(AccountNumber));
+
+		if (Amount < 0 && !CanWithdraw(*Client, -Amount))
+			return enStoreInsufficientFunds;
+
+		Client->AccountBalance += Amount;
+		UpdateBalanceColumn(*Client);
+		QueueHistoryEntry(MakeHistoryEntry(*Client, (Amount < 0) ? 'W' : 'D', Amount));
+		Batch = AppendRecordToJournal(ConvertBalanceToJournalLine(*Client, "#//#"), CompactJournal);
+
+		NewBalance = Client->AccountBalance;
+	}
+
+	if (CompactJournal)
+		CompactClientJournal();
+
+	WaitForJournalBatch(Batch);
+	return enStoreDone;
+}
+
+/**
+ * @brief Deposits an amount to a client and journals the new balance.
+ * @param AccountNumber Account number.
+ * @param Amount Amount in cents, must be positive.
+ * @param NewBalance Output balance after the deposit.
+ * @return enStoreDone, enStoreNotFound or enStoreInvalidAmount.
+ */
+enStoreResult DepositToClient(string AccountNumber, Money Amount, Money& NewBalance) {
+
+	if (Amount <= 0)
+		return enStoreInvalidAmount;
+
+	return ChangeClientBalance(AccountNumber, Amount, NewBalance);
+}
+
+/**
+ * @brief Withdraws an amount from a client and journals the new balance.
+ * @param AccountNumber Account number.
+ * @param Amount Amount in cents, must be positive.
+ * @param NewBalance Output balance after the withdraw.
+ * @return enStoreDone, enStoreNotFound, enStoreInvalidAmount or enStoreInsufficientFunds.
+ */
+enStoreResult WithdrawFromClient(string AccountNumber, Money Amount, Money& NewBalance) {
+
+	if (Amount <= 0)
+		return enStoreInvalidAmount;
+
+	return ChangeClientBalance(AccountNumber, -Amount, NewBalance);
+}
+
+/**
+ * @brief Moves an amount from one client to another with one journal record.
+ *
+ * Both account locks are held while the balances change. They are taken
+ * lowest stripe first, so two transfers between the same accounts in
+ * opposite directions cannot wait on each other. Returns once the
+ * journal batch holding the transfer is on the disk.
+ *
+ * @param FromAccountNumber Account the money leaves.
+ * @param ToAccountNumber Account the money goes to.
+ * @param Amount Amount in cents, must be positive.
+ * @param FromBalance Output balance of the first account after the transfer.
+ * @param ToBalance Output balance of the second account after the transfer.
+ * @return enStoreDone, enStoreNotFound, enStoreInvalidAmount, enStoreInsufficientFunds,
+ *         or enStoreNotAllowed for a transfer to the same account.
+ */
+enStoreResult TransferBetweenClients(const string& FromAccountNumber, const string& ToAccountNumber, Money Amount, Money& FromBalance, Money& ToBalance) {
+
+	if (Amount <= 0)
+		return enStoreInvalidAmount;
+
+	if (FromAccountNumber == ToAccountNumber)
+		return enStoreNotAllowed;
+
+	bool CompactJournal = false;
+	uint64_t Batch = 0;
+
+	{
+		shared_lock <shared_mutex> RepositoryLock(ClientsMutex);
+
+		stClient* FromClient = GetClientByAccountNumber(FromAccountNumber);
+		stClient* ToClient = GetClientByAccountNumber(ToAccountNumber);
+
+		if (FromClient == nullptr || ToClient == nullptr)
+			return enStoreNotFound;
+
+		size_t FromStripe = GetAccountLockStripe(FromAccountNumber);
+		size_t ToStripe = GetAccountLockStripe(ToAccountNumber);
+
+		unique_lock <mutex> FirstLock(AccountLocks[min(FromStripe, ToStripe)]);
+		unique_lock <mutex> SecondLock;
+
+		if (FromStripe != ToStripe)
+			SecondLock = unique_lock <mutex>(AccountLocks[max(FromStripe, ToStripe)]);
+
+		if (!CanWithdraw(*FromClient, Amount))
+			return enStoreInsufficientFunds;
+
+		FromClient->AccountBalance -= Amount;
+		ToClient->AccountBalance += Amount;
+		UpdateBalanceColumn(*FromClient);
+		UpdateBalanceColumn(*ToClient);
+		QueueHistoryEntry(MakeHistoryEntry(*FromClient, 'T', -Amount));
+		QueueHistoryEntry(MakeHistoryEntry(*ToClient, 'T', Amount));
+		Batch = AppendRecordToJournal(ConvertTransferToJournalLine(*FromClient, *ToClient, "#//#"), CompactJournal);
+
+		FromBalance = FromClient->AccountBalance;
+		ToBalance = ToClient->AccountBalance;
+	}
+
+	if (CompactJournal)
+		CompactClientJournal();
+
+	WaitForJournalBatch(Batch);
+	return enStoreDone;
+}
+
+/**
+ * @brief Adds a new user to the users repository and file.
+ * @param User User record, with the plaintext password to hash.
+ * @return enStoreDone, or enStoreAlreadyExists if the username is taken.
+ */
+enStoreResult AddUserToStore(stUser User) {
+
+	User.Password = HashPassword(User.Password);
+
+	lock_guard <mutex> Lock(UsersMutex);
+	ParsePendingUsers();
+
+	if (GetUserByUserName(User.UserName) != nullptr)
+		return enStoreAlreadyExists;
+
+	UsersRepository.UserNameIndex[User.UserName] = UsersRepository.vUsers.size();
+	UsersRepository.vUsers.push_back(User);
+
+	// A journaled delete of the same username would hide the appended
+	// line on the next load, so the file is saved whole while there are deletes.
+	if (UsersRepository.DeletedUsers > 0)
+		SaveUsersRepository();
+	else
+		AddDataLineToFile(ConvertRecordToLine(User, "#//#"), UserFileName);
+
+	return enStoreDone;
+}
+
+/**
+ * @brief Replaces the record of an existing user and saves the users file.
+ * @param User New user record, found by its username, with the plaintext password to hash.
+ * @return enStoreDone, or enStoreNotFound.
+ */
+enStoreResult UpdateUserInStore(stUser User) {
+
+	User.Password = HashPassword(User.Password);
+
+	lock_guard <mutex> Lock(UsersMutex);
+	ParsePendingUsers();
+
+	stUser* StoredUser = GetUserByUserName(User.UserName);
+
+	if (StoredUser == nullptr)
+		return enStoreNotFound;
+
+	*StoredUser = User;
+	VerifiedSessions.erase(User.UserName);
+	SaveUsersRepository();
+
+	return enStoreDone;
+}
+
+/**
+ * @brief Deletes a user and journals the delete. The Admin user cannot be deleted.
+ *
+ * The user stays in memory as a tombstone until the compactor rewrites
+ * the users file.
+ *
+ * @param UserName Username.
+ * @return enStoreDone, enStoreNotFound or enStoreNotAllowed.
+ */
+enStoreResult DeleteUserFromStore(string UserName) {
+
+	if (UserName == "Admin")
+		return enStoreNotAllowed;
+
+	lock_guard <mutex> Lock(UsersMutex);
+	ParsePendingUsers();
+
+	if (!MarkUserForDeleteByUsername(UserName))
+		return enStoreNotFound;
+
+	VerifiedSessions.erase(UserName);
+
+	if (!WriteFileDurably(UserJournalFileName, "X#//#" + UserName + "\n", true))
+		SaveUsersRepository();
+	else if (IsGarbageCompactionDue(UsersRepository.DeletedUsers, UsersRepository.vUsers.size()))
+		ScheduleGarbageCompaction();
+
+	return enStoreDone;
+}
+
+/**
+ * @brief Deletes a client by account number.
+ * @param AccountNumber Account number.
+ * @return True if deleted, false otherwise.
+ */
+bool DeleteClientByAccountNumber(string AccountNumber) {
+
+	stClient Client;
+	char Answer = 'N';
+
+	if (FindClientByAccountNumber(AccountNumber, Client)) {
+		PrintClientData(Client);
+
+		cout << "\nAre you sure you want to delete this client? Y/N? ";
+		cin >> Answer;
+		if (toupper(Answer) == 'Y') {
+			if (DeleteClientFromStore(AccountNumber) != enStoreDone) {
+				cout << "\n\nDelete Failed, Client with Account Number (" << AccountNumber << ") is Not Found!" << endl;
+				return false;
+			}
+
+			cout << "\n\nClient deleted Successfully" << endl;
+			return true;
+		}
+	}
+	else {
+		cout << "\nClient with Account Number (" << AccountNumber << ") is Not Found!\n";
+		return false;
+	}
+
+	return false;
+}
+
+/**
+ * @brief Deletes a user by username.
+ * @param UserName.
+ * @return True if deleted, false otherwise.
+ */
+bool DeleteUserByUsername(string UserName) {
+
+	if (UserName == "Admin") {
+		cout << "\n\nYou cannot Delete This User.";
+		return false;
+	}
+
+	stUser User;
+	char Answer = 'N';
+
+	if (FindUserByUserName(UserName, User)) {
+		PrintUserData(User);
+
+		cout << "\nAre you sure you want to delete this client? Y/N? ";
+		cin >> Answer;
+		if (toupper(Answer) == 'Y') {
+			DeleteUserFromStore(UserName);
+
+			cout << "\nUser deleted Successfully" << endl;
+			return true;
+		}
+	}
+	else {
+		cout << "\nClient with Username (" << UserName << ") is Not Found!\n";
+		return false;
+	}
+}
+
+/**
+ * @brief Updates a clients record by re-entering data.
+ * @param AccountNumber The account number.
+ * @return Updated client record.
+ */
+stClient UpdateClientRecord(string AccountNumber) {
+
+	stClient ClientData;
+
+	ClientData.AccountNumber = AccountNumber;
+
+	cout << "\nEnter PinCode? ";
+	getline(cin >> ws, ClientData.PinCode);
+
+	cout << "Enter Name? ";
+	getline(cin, ClientData.FullName);
+
+	cout << "Enter Phone? ";
+	getline(cin, ClientData.PhoneNumber);
+
+	cout << "Enter AccountBalance? ";
+	ClientData.AccountBalance = ReadMoney();
+
+	return ClientData;
+}
+
+/**
+ * @brief Updates a users record by re-entering data.
+ * @param Username.
+ * @return Updated user record.
+ */
+stUser UpdateUserRecord(string Username) {
+
+	stUser User;
+
+	User.UserName = Username;
+
+	cout << "Enter Password? ";
+	getline(cin >> ws, User.Password);
+
+	User.Permissions = ReadPermissions();
+
+	return User;
+}
+
+/**
+ * @brief Updates a client in file by account number.
+ * @param AccountNumber The account number.
+ * @return True if updated, false otherwise.
+ */
+bool UpdateClientByAccountNumber(string AccountNumber) {
+
+	stClient Client;
+	char Answer = 'N';
+
+	if (FindClientByAccountNumber(AccountNumber, Client)) {
+		PrintClientData(Client);
+
+		cout << "\nAre you sure you want to Update this client? Y/N? ";
+		cin >> Answer;
+		if (toupper(Answer) == 'Y') {
+			stClient UpdatedClient = UpdateClientRecord(AccountNumber);
+
+			if (!cin) {
+				cout << "\n\nUpdate Cancelled, the input ended." << endl;
+				return false;
+			}
+
+			if (UpdateClientInStore(UpdatedClient) != enStoreDone) {
+				cout << "\n\nUpdate Failed, Client with Account Number (" << AccountNumber << ") is Not Found!" << endl;
+				return false;
+			}
+
+			cout << "\n\nClient Updated Successfully" << endl;
+			return true;
+		}
+	}
+	else {
+		cout << "\nClient with Account Number (" << AccountNumber << ") is Not Found!\n";
+		return false;
+	}
+
+	return false;
+}
+
+/**
+ * @brief Updates a user in file by username.
+ * @param Username.
+ * @return True if updated, false otherwise.
+ */
+bool UpdateUserByUsername(string Username) {
+
+	stUser User;
+	char Answer = 'N';
+
+	if (FindUserByUserName(Username, User)) {
+		PrintUserData(User);
+
+		cout << "\nAre you sure you want to Update this User? Y/N? ";
+		cin >> Answer;
+		if (toupper(Answer) == 'Y') {
+			UpdateUserInStore(UpdateUserRecord(Username));
+
+			cout << "\n\nUser Updated Successfully" << endl;
+			return true;
+		}
+	}
+	else {
+		cout << "\nUser with User Name (" << Username << ") is Not Found!\n";
+		return false;
+	}
+}
+
+/**
+ * @brief Adds a single client to the file.
+ * @return False if the input ended before the client was read, true otherwise.
+ */
+bool AddNewClients() {
+	stClient ClientData;
+	ReadClientData(ClientData);
+
+	if (!cin)
+		return false;
+
+	AddClientToStore(ClientData);
+	return true;
+}
+
+/**
+ * @brief Adds a single user to the file.
+ */
+void AddNewUsers() {
+	stUser User;
+	ReadUserData(User);
+
+	AddUserToStore(User);
+}
+
+/**
+ * @brief Adds multiple clients interactively.
+ */
+void AddClient() {
+	char AddMore = 'Y';
+
+	do {
+		cout << "Adding New Client:\n\n";
+
+		if (!AddNewClients())
+			return;
+
+		cout << "\nClient Added Successfully, do you want to add more clients? Y/N? ";
+		cin >> AddMore;
+	} while (cin && toupper(AddMore) == 'Y');
+}
+
+/**
+ * @brief Adds multiple users interactively.
+ */
+void AddUser() {
+	char AddMore = 'Y';
+
+	do {
+		cout << "Adding New User:\n\n";
+		AddNewUsers();
+		cout << "\nUser Added Successfully, do you want to add more Users? Y/N? ";
+		cin >> AddMore;
+	} while (toupper(AddMore) == 'Y');
+}
+
+/**
+ * @brief Performs deposit operation for a client.
+ * @return True if successful.
+ */
+bool DepositAmountByClientNumber() {
+
+	string AccountNumber = ReadClientAccountNumber();
+	stClient Client;
+	char Answer = 'N';
+
+	while (!FindClientByAccountNumber(AccountNumber, Client)) {
+		cout << "Client with [" << AccountNumber << "] does not Found!\n";
+		AccountNumber = ReadClientAccountNumber();
+	}
+
+	PrintClientData(Client);
+	Money DepositAmount = ReadDepositAmount();
+
+	cout << "Are you Sure you want perform this transaction? y/n ? ";
+	cin >> Answer;
+
+	if (toupper(Answer) == 'Y') {
+		Money NewBalance = 0;
+
+		if (DepositToClient(AccountNumber, DepositAmount, NewBalance) != enStoreDone) {
+			cout << "\n\nDeposit Failed, Client with [" << AccountNumber << "] does not Found!" << endl;
+			return false;
+		}
+
+		cout << "\n\nAmount Deposit Successfully" << endl;
+		cout << "New Balance of [" << AccountNumber << "] : " << FormatMoney(NewBalance) << endl;
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ * @brief Performs withdrawal operation for a client.
+ * @return True if successful.
+ */
+bool WithdrawAmountByClientNumber() {
+
+	string AccountNumber = ReadClientAccountNumber();
+	stClient Client;
+	char Answer = 'N';
+
+	while (!FindClientByAccountNumber(AccountNumber, Client)) {
+		cout << "Client with [" << AccountNumber << "] does not Found!\n";
+		AccountNumber = ReadClientAccountNumber();
+	}
+
+	PrintClientData(Client);
+	Money WithdrawAmount = ReadWithdrawAmount();
+
+	while (cin && !CanWithdraw(Client, WithdrawAmount)) {
+		cout << "Amoount Exceeds the balance, you can withdraw up to : " << FormatMoney(Client.AccountBalance) << endl;
+		WithdrawAmount = ReadWithdrawAmount();
+	}
+
+	cout << "Are you Sure you want perform this transaction? y/n ? ";
+	cin >> Answer;
+
+	if (toupper(Answer) == 'Y') {
+		Money NewBalance = 0;
+
+		switch (WithdrawFromClient(AccountNumber, WithdrawAmount, NewBalance)) {
+		case enStoreDone:
+			break;
+		case enStoreInsufficientFunds:
+			cout << "\n\nWithdraw Failed, the balance changed meanwhile." << endl;
+			return false;
+		default:
+			cout << "\n\nWithdraw Failed, Client with [" << AccountNumber << "] does not Found!" << endl;
+			return false;
+		}
+
+		cout << "\n\nAmount Withdraw Successfully" << endl;
+		cout << "New Balance of [" << AccountNumber << "] : " << FormatMoney(NewBalance) << endl;
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ * @brief Performs a transfer between two clients.
+ * @return True if successful.
+ */
+bool TransferAmountBetweenClients() {
+
+	stClient FromClient, ToClient;
+	char Answer = 'N';
+
+	cout << "Transfer From:\n";
+	string FromAccountNumber = ReadClientAccountNumber();
+
+	while (!FindClientByAccountNumber(FromAccountNumber, FromClient)) {
+		cout << "Client with [" << FromAccountNumber << "] does not Found!\n";
+		FromAccountNumber = ReadClientAccountNumber();
+	}
+
+	PrintClientData(FromClient);
+
+	cout << "\nTransfer To:\n";
+	string ToAccountNumber = ReadClientAccountNumber();
+
+	while (ToAccountNumber == FromAccountNumber || !FindClientByAccountNumber(ToAccountNumber, ToClient)) {
+		if (ToAccountNumber == FromAccountNumber)
+			cout << "Cannot transfer to the same account!\n";
+		else
+			cout << "Client with [" << ToAccountNumber << "] does not Found!\n";
+		ToAccountNumber = ReadClientAccountNumber();
+	}
+
+	PrintClientData(ToClient);
+
+	cout << "\nPlease enter Transfer Amount? ";
+	Money TransferAmount = ReadPositiveMoney();
+
+	while (cin && !CanWithdraw(FromClient, TransferAmount)) {
+		cout << "Amoount Exceeds the balance, you can transfer up to : " << FormatMoney(FromClient.AccountBalance) << endl;
+		cout << "\nPlease enter Transfer Amount? ";
+		TransferAmount = ReadPositiveMoney();
+	}
+
+	cout << "Are you Sure you want perform this transaction? y/n ? ";
+	cin >> Answer;
+
+	if (toupper(Answer) == 'Y') {
+		Money FromBalance = 0, ToBalance = 0;
+
+		switch (TransferBetweenClients(FromAccountNumber, ToAccountNumber, TransferAmount, FromBalance, ToBalance)) {
+		case enStoreDone:
+			break;
+		case enStoreInsufficientFunds:
+			cout << "\n\nTransfer Failed, the balance of [" << FromAccountNumber << "] changed meanwhile and does not cover the amount." << endl;
+			return false;
+		case enStoreNotFound:
+			cout << "\n\nTransfer Failed, Client with [" << (FindClientByAccountNumber(FromAccountNumber, FromClient) ? ToAccountNumber : FromAccountNumber) << "] does not Found!" << endl;
+			return false;
+		case enStoreInvalidAmount:
+			cout << "\n\nTransfer Failed, the amount is not valid." << endl;
+			return false;
+		default:
+			cout << "\n\nTransfer Failed, cannot transfer to the same account." << endl;
+			return false;
+		}
+
+		cout << "\n\nAmount Transferred Successfully" << endl;
+		cout << "New Balance of [" << FromAccountNumber << "] : " << FormatMoney(FromBalance) << endl;
+		cout << "New Balance of [" << ToAccountNumber << "] : " << FormatMoney(ToBalance) << endl;
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ * @brief Prints the totals of the balances.
+ * @param Summary Totals to print.
+ */
+void PrintBalanceSummary(const stBalanceSummary& Summary) {
+
+	cout << "\t\t\t\tTotal Balances = " << FormatMoney(Summary.TotalBalances) << "\n\n";
+	cout << "\t\t\t\tClients = " << Summary.ClientCount;
+	cout << ", Min = " << FormatMoney(Summary.MinBalance);
+	cout << ", Max = " << FormatMoney(Summary.MaxBalance) << "\n\n";
+
+	for (int Bucket = 0; Bucket < BalanceBucketCount; Bucket++) {
+		cout << "\t\t\t\t" << left << setw(30) << GetBalanceBucketLabel(Bucket);
+		cout << ": " << Summary.vBuckets[Bucket] << " Client(s)\n";
+	}
+}
+
+/**
+ * @brief Prints the balance of every active client.
+ */
+void PrintClientsBalances() {
+
+	shared_lock <shared_mutex> Lock(ClientsMutex);
+
+	cout << "\n_______________________________________________________";
+	cout << "_________________________________________\n" << endl;
+	cout << "| " << left << setw(15) << "Accout Number";
+	cout << "| " << left << setw(40) << "Client Name";
+	cout << "| " << left << setw(12) << "Balance";
+	cout << "\n_______________________________________________________";
+	cout << "_________________________________________\n" << endl;
+
+	for (stClient& Client : ClientsRepository.vClients) {
+		if (Client.MarkForDelete != true) {
+			PrintClientsDataForTotalBalances(Client);
+			cout << endl;
+		}
+	}
+
+	cout << "\n_______________________________________________________";
+	cout << "_________________________________________\n" << endl;
+}
+
+/**
+ * @brief Prints total balances report.
+ *
+ * The totals come from the running totals, so they show at once. The
+ * client list and a full recount are offered on request.
+ */
+void ShowTotalBalnces() {
+	stBalanceSummary Summary = GetRunningTotals();
+	char Answer = 'N';
+
+	cout << "\n\t\t\t\t\tBalances of (" << Summary.ClientCount << ") Client(s).\n\n";
+	PrintBalanceSummary(Summary);
+
+	cout << "\nShow the balance of every client? y/n ? ";
+	cin >> Answer;
+
+	if (toupper(Answer) == 'Y')
+		PrintClientsBalances();
+
+	Answer = 'N';
+	cout << "\nVerify the totals with a full recount? y/n ? ";
+	cin >> Answer;
+
+	if (toupper(Answer) == 'Y') {
+		if (VerifyRunningTotals(Summary))
+			cout << "\nThe totals match a full recount.\n\n";
+		else
+			cout << "\nThe totals did not match a full recount and were corrected:\n\n";
+
+		PrintBalanceSummary(Summary);
+	}
+}
+
+/**
+ * @brief Parses a posting line: AccountNumber#//#D or W#//#Amount.
+ * @param Line Posting line.
+ * @param Posting Output posting.
+ * @param Seperator Delimiter between fields.
+ * @return True if the line is a valid posting, false otherwise.
+ */
+bool ConvertPostingLineToRecord(string_view Line, stPosting& Posting, string_view Seperator = "#//#") {
+
+	string_view vPosting[3];
+
+	if (SplitLine(Line, Seperator, vPosting, 3) != 3 || vPosting[0].empty() || vPosting[1].size() != 1)
+		return false;
+
+	Posting.Type = (char)toupper((unsigned char)vPosting[1][0]);
+	if (Posting.Type != enPostingDeposit && Posting.Type != enPostingWithdraw)
+		return false;
+
+	if (!ParseMoney(vPosting[2], Posting.Amount) || Posting.Amount <= 0)
+		return false;
+
+	Posting.AccountNumber = vPosting[0];
+	return true;
+}
+
+/**
+ * @brief Applies one posting to a client, following the same rules as
+ *        the deposit and withdraw screens.
+ * @param Client Client to post to.
+ * @param Posting Posting to apply.
+ * @return Empty string if applied, otherwise the reject reason.
+ */
+string ApplyPosting(stClient& Client, const stPosting& Posting) {
+
+	if (Posting.Type == enPostingWithdraw) {
+		if (!CanWithdraw(Client, Posting.Amount))
+			return "insufficient funds";
+
+		Client.AccountBalance -= Posting.Amount;
+	}
+	else
+		Client.AccountBalance += Posting.Amount;
+
+	return "";
+}
+
+/**
+ * @brief Runs Task(0) .. Task(TaskCount - 1) each on its own thread and
+ *        waits for all of them. Task 0 runs on the calling thread.
+ * @param TaskCount Number of tasks.
+ * @param Task Task to run, called with the task index.
+ */
+void RunInParallel(size_t TaskCount, const function <void(size_t)>& Task) {
+
+	vector <thread> vThreads;
+
+	for (size_t i = 1; i < TaskCount; i++)
+		vThreads.emplace_back(Task, i);
+
+	if (TaskCount != 0)
+		Task(0);
+
+	for (thread& T : vThreads)
+		T.join();
+}
+
+/**
+ * @brief Gets the number of worker threads to use.
+ * @param RequestedThreads Requested number, 0 for one per core.
+ * @return Number of worker threads, at least 1 and at most
+ *         MaxWorkerThreadsPerCore per core.
+ */
+unsigned GetWorkerThreadCount(unsigned RequestedThreads) {
+
+	unsigned Cores = max(1u, thread::hardware_concurrency());
+
+	if (RequestedThreads == 0)
+		return Cores;
+
+	return min(RequestedThreads, Cores * MaxWorkerThreadsPerCore);
+}
+
+/**
+ * @brief Splits a block of text into about ChunkCount chunks that each
+ *        end right after a line end.
+ * @param Data Text to split.
+ * @param ChunkCount Wanted number of chunks.
+ * @return The chunks, in order, covering the whole text.
+ */
+vector <string_view> SplitIntoLineChunks(string_view Data, size_t ChunkCount) {
+
+	vector <string_view> vChunks;
+	size_t Begin = 0;
+
+	for (size_t i = 1; i <= ChunkCount && Begin < Data.size(); i++) {
+		size_t End = (i == ChunkCount) ? Data.size() : max(Begin, Data.size() / ChunkCount * i);
+		size_t NewLine = Data.find('\n', End);
+
+		End = (i == ChunkCount || NewLine == string_view::npos) ? Data.size() : NewLine + 1;
+		vChunks.push_back(Data.substr(Begin, End - Begin));
+		Begin = End;
+	}
+
+	return vChunks;
+}
+
+/**
+ * @brief Writes the rejected postings to the rejects file, in line order.
+ * @param FileName Rejects file.
+ * @param vRejects Rejected postings.
+ */
+void SaveRejectedPostings(string FileName, vector <stRejectedPosting>& vRejects) {
+
+	sort(vRejects.begin(), vRejects.end(),
+		[](const stRejectedPosting& A, const stRejectedPosting& B) { return A.LineNumber < B.LineNumber; });
+
+	string Rejects;
+
+	for (stRejectedPosting& R : vRejects) {
+		Rejects += to_string(R.LineNumber);
+		Rejects += "#//#";
+		Rejects.append(R.Line.data(), R.Line.size());
+		Rejects += "#//#";
+		Rejects += R.Reason;
+		Rejects += '\n';
+	}
+
+	fstream RejectsFile;
+	RejectsFile.open(FileName, ios::out | ios::binary);
+	if (RejectsFile.is_open()) {
+		RejectsFile.write(Rejects.data(), Rejects.size());
+		RejectsFile.close();
+	}
+}
+
+/**
+ * @brief Applies a whole posting file to the clients repository.
+ *
+ * The file is handled in two parallel phases:
+ *  - Parse: the file is cut into one chunk per thread, and each chunk is
+ *    parsed and its postings split into shards by hash of AccountNumber.
+ *  - Apply: each worker owns one shard and applies its postings chunk by
+ *    chunk, so every account sees its postings in file order and the
+ *    overdraft check gives the same result as a single-threaded run.
+ *    An account only ever belongs to one shard, so no locks are needed.
+ *
+ * Postings that are malformed, target an unknown account or would
+ * overdraw an account are written to PostingFileName + ".rejects" as
+ * LineNumber#//#Line#//#Reason. The repository is saved once at the end,
+ * and the history of the postings is written along with it.
+ *
+ * @param PostingFileName Posting file, one AccountNumber#//#D or W#//#Amount per line.
+ * @param RequestedThreads Number of worker threads, 0 for one per core.
+ * @return True if the file was processed, false if it could not be read
+ *         or the clients could not be saved.
+ */
+bool ProcessPostingFile(string PostingFileName, unsigned RequestedThreads) {
+
+	stMappedFile PostingFile;
+
+	if (!OpenMappedFile(PostingFileName, PostingFile)) {
+		cerr << "Error: cannot open " << PostingFileName << ".\n";
+		CloseMappedFile(PostingFile);
+		return false;
+	}
+
+	size_t ShardCount = GetWorkerThreadCount(RequestedThreads);
+	vector <stPostingChunk> vChunks;
+
+	for (string_view Data : SplitIntoLineChunks(string_view(PostingFile.Data, PostingFile.Size), ShardCount)) {
+		stPostingChunk Chunk;
+		Chunk.Data = Data;
+		Chunk.vShards.resize(ShardCount);
+		vChunks.push_back(move(Chunk));
+	}
+
+	RunInParallel(vChunks.size(), [&](size_t ChunkIndex) {
+		stPostingChunk& Chunk = vChunks[ChunkIndex];
+		hash <string_view> HashAccountNumber;
+
+		ForEachLine(Chunk.Data, [&](string_view Line, size_t LineNumber) {
+			stPosting Posting;
+
+			if (ConvertPostingLineToRecord(Line, Posting)) {
+				Posting.LineNumber = LineNumber;
+				Posting.Line = Line;
+				Chunk.vShards[HashAccountNumber(Posting.AccountNumber) % ShardCount].push_back(Posting);
+			}
+			else
+				Chunk.vRejects.push_back({ LineNumber, Line, "malformed line" });
+		});
+	});
+
+	size_t NextLineNumber = 1;
+	for (stPostingChunk& Chunk : vChunks) {
+		Chunk.FirstLineNumber = NextLineNumber;
+		NextLineNumber += (size_t)count(Chunk.Data.begin(), Chunk.Data.end(), '\n');
+	}
+
+	vector <vector <stRejectedPosting>> vShardRejects(ShardCount);
+	vector <vector <stHistoryEntry>> vShardHistory(ShardCount);
+	vector <size_t> vShardApplied(ShardCount, 0);
+	shared_lock <shared_mutex> RepositoryLock(ClientsMutex);
+
+	RunInParallel(ShardCount, [&](size_t Shard) {
+		string AccountNumber;
+
+		for (stPostingChunk& Chunk : vChunks) {
+			for (stPosting& Posting : Chunk.vShards[Shard]) {
+				AccountNumber.assign(Posting.AccountNumber);
+				stClient* Client = GetClientByAccountNumber(AccountNumber);
+				string Reason = (Client == nullptr) ? "unknown account" : ApplyPosting(*Client, Posting);
+
+				if (Reason.empty()) {
+					UpdateBalanceColumn(*Client);
+					vShardHistory[Shard].push_back(MakeHistoryEntry(*Client, Posting.Type,
+						(Posting.Type == enPostingWithdraw) ? -Posting.Amount : Posting.Amount));
+					vShardApplied[Shard]++;
+				}
+				else
+					vShardRejects[Shard].push_back({ Posting.LineNumber + Chunk.FirstLineNumber - 1, Posting.Line, Reason });
+			}
+		}
+	});
+
+	RepositoryLock.unlock();
+
+	vector <stRejectedPosting> vRejects;
+	size_t Applied = 0;
+
+	for (stPostingChunk& Chunk : vChunks) {
+		for (stRejectedPosting& R : Chunk.vRejects) {
+			R.LineNumber += Chunk.FirstLineNumber - 1;
+			vRejects.push_back(move(R));
+		}
+	}
+	for (size_t Shard = 0; Shard < ShardCount; Shard++) {
+		Applied += vShardApplied[Shard];
+		for (stRejectedPosting& R : vShardRejects[Shard])
+			vRejects.push_back(move(R));
+		for (stHistoryEntry& Entry : vShardHistory[Shard]) {
+			Entry.Operator = "posting";
+			QueueHistoryEntry(move(Entry));
+		}
+	}
+
+	SaveRejectedPostings(PostingFileName + ".rejects", vRejects);
+	CloseMappedFile(PostingFile);
+
+	if (Applied != 0) {
+		lock_guard <shared_mutex> Lock(ClientsMutex);
+
+		if (!SaveClientsRepository()) {
+			cerr << "Error: cannot save the clients, the " << Applied << " applied posting(s) were lost.\n";
+			return false;
+		}
+	}
+
+	cout << "Applied " << Applied << " posting(s), rejected " << vRejects.size() << " posting(s) using "
+		<< ShardCount << " thread(s).\n";
+	if (!vRejects.empty())
+		cout << "Rejected postings written to " << PostingFileName << ".rejects\n";
+
+	return true;
+}
+
+/**
+ * @brief Displays the "Delete Client" screen and handles client removal.
+ *
+ * This function is responsible for the client deletion workflow. The
+ * `pDeleteClient` permission is checked by the menu before it runs.
+ *
+ *  - A header for the delete client screen is displayed.
+ *  - The user is prompted to enter a client account number.
+ *  - The function `DeleteClientByAccountNumber()` is called to remove the
+ *    client with the given account number.
+ */
+void ShowDeleteClientScreen() {
+
+	cout << "\n---------------------------------------------------------------\n";
+	cout << "\t\tDelete Client Screen\n";
+	cout << "---------------------------------------------------------------\n";
+
+	string AccountNumber = ReadClientAccountNumber();
+	DeleteClientByAccountNumber(AccountNumber);
+}
+
+/**
+ * @brief Displays the "Delete User" screen and removes a user by username.
+ *
+ * This function handles the process of deleting a user from the system.
+ * It provides a simple console interface to:
+ *  - Display a header for the "Delete User" screen.
+ *  - Prompt the administrator to enter the username of the account to be deleted.
+ *  - Load the list of existing users from the file (`UserFileName`).
+ *  - Call `DeleteUserByUsername()` to remove the specified user from the system.
+ */
+void ShowDeleteUserScreen() {
+
+	cout << "\n---------------------------------------------------------------\n";
+	cout << "\t\tDelete User Screen\n";
+	cout << "---------------------------------------------------------------\n";
+
+	string UserName = "";
+
+	cout << "\nEnter Username? ";
+	cin >> UserName;
+
+	DeleteUserByUsername(UserName);
+}
+
+/**
+ * @brief Displays the "Add New Clients" screen and handles client creation.
+ *
+ * This function provides a console interface for adding new clients to the system.
+ * It performs the following steps:
+ *  - Displays a formatted header for the "Add New Clients" screen.
+ *  - Calls `AddClient()` to handle the actual client input and storage.
+ */
+void ShowAddNewClientScreen() {
+
+	cout << "\n---------------------------------------------------------------\n";
+	cout << "\t\tAdd New Clients Screen\n";
+	cout << "---------------------------------------------------------------\n\n";
+
+	AddClient();
+}
+
+void ShowAddNewUserScreen() {
+	cout << "\n---------------------------------------------------------------\n";
+	cout << "\t\tAdd New Users Screen\n";
+	cout << "---------------------------------------------------------------\n\n";
+
+	AddUser();
+}
+
+void ShowUpdateClientInfoScreen() {
+
+	cout << "\n---------------------------------------------------------------\n";
+	cout << "\t\tUpdate Client Info Screen\n";
+	cout << "---------------------------------------------------------------\n\n";
+
+	string AccountNumber = ReadClientAccountNumber();
+	UpdateClientByAccountNumber(AccountNumber);
+}
+
+void ShowUpdateUserInfoScreen() {
+	cout << "\n---------------------------------------------------------------\n";
+	cout << "\t\tUpdate User Info Screen\n";
+	cout << "---------------------------------------------------------------\n\n";
+
+	string UserName = "";
+
+	cout << "Enter Username? ";
+	cin >> UserName;
+
+	UpdateUserByUsername(UserName);
+}
+
+/**
+ * @brief Reads a number in a range from user, asking again until it is valid.
+ * @param Message Question to show.
+ * @param From Smallest valid number.
+ * @param To Largest valid number.
+ * @return The number, From if the input ended.
+ */
+short ReadNumberInRange(const string& Message, short From, short To) {
+
+	short Number = From - 1;
+
+	do {
+		cout << Message << " [" << From << " to " << To << "]? ";
+		cin >> Number;
+
+		if (cin.fail() && !cin.eof()) {
+			cin.clear();
+			cin.ignore(numeric_limits<streamsize>::max(), '\n');
+		}
+	} while (cin && (Number < From || Number > To));
+
+	return cin ? Number : From;
+}
+
+/**
+ * @brief Asks how to show the client list.
+ * @param PageSize Output rows per page.
+ * @param SortKey Output order, one of enClientListSortKey.
+ * @param Filter Output text the listed clients must contain, empty for all.
+ */
+void ReadClientListOptions(size_t& PageSize, short& SortKey, string& Filter) {
+
+	PageSize = ReadNumberInRange("Rows per page?", 1, MaxClientListPageSize);
+
+	cout << "\nSort by:\n";
+	cout << "\t[1] File order.\n";
+	cout << "\t[2] Account Number.\n";
+	cout << "\t[3] Name.\n";
+	cout << "\t[4] Balance, highest first.\n";
+	SortKey = ReadNumberInRange("Sort by?", enSortByFileOrder, enSortByBalance);
+
+	cout << "\nShow only clients whose name or account number contains (* for all)? ";
+	if (!getline(cin >> ws, Filter) || Filter == "*")
+		Filter.clear();
+}
+
+/**
+ * @brief Collects the rows of the client list in the chosen order.
+ *
+ * Only row numbers are gathered here, the clients are read a page at
+ * a time when the page is printed. Sorting by name walks the name
+ * index, which is kept in order already.
+ *
+ * Rows move when the compactor erases deleted clients, so callers hold
+ * ClientsMutex from collecting the rows until the page is printed.
+ *
+ * @param SortKey One of enClientListSortKey.
+ * @param Filter Text the name or account number must contain, ignoring case, empty for all.
+ * @return Rows of the listed clients.
+ */
+vector <uint32_t> GetClientListRows(short SortKey, const string& Filter) {
+
+	vector <stClient>& vClients = ClientsRepository.vClients;
+	stClientsColumns& Columns = ClientsRepository.Columns;
+	string LowerFilter = ConvertToLowerCase(Filter);
+	vector <uint32_t> vRows;
+
+	auto IsListed = [&](size_t Position) {
+		return Columns.vIsActive[Position] == 1 && (LowerFilter.empty()
+			|| ContainsIgnoringCase(vClients[Position].FullName, LowerFilter)
+			|| ContainsIgnoringCase(vClients[Position].AccountNumber, LowerFilter));
+	};
+
+	if (SortKey == enSortByName) {
+		for (auto& Entry : ClientsRepository.NameIndex.Sorted) {
+			if (IsListed(Entry.second))
+				vRows.push_back((uint32_t)Entry.second);
+		}
+
+		return vRows;
+	}
+
+	for (size_t Position = 0; Position < vClients.size(); Position++) {
+		if (IsListed(Position))
+			vRows.push_back((uint32_t)Position);
+	}
+
+	if (SortKey == enSortByAccountNumber)
+		sort(vRows.begin(), vRows.end(), [&](uint32_t A, uint32_t B) { return vClients[A].AccountNumber < vClients[B].AccountNumber; });
+	else if (SortKey == enSortByBalance)
+		stable_sort(vRows.begin(), vRows.end(), [&](uint32_t A, uint32_t B) { return Columns.vBalances[A] > Columns.vBalances[B]; });
+
+	return vRows;
+}
+
+/**
+ * @brief Appends a table cell padded to its width, like setw with left.
+ * @param Buffer Page being built.
+ * @param Text Cell text.
+ * @param Width Cell width.
+ */
+void AppendTableCell(string& Buffer, string_view Text, size_t Width) {
+
+	Buffer += "| ";
+	Buffer += Text;
+
+	if (Text.size() < Width)
+		Buffer.append(Width - Text.size(), ' ');
+}
+
+/**
+ * @brief Formats one page of the client list into a buffer and prints it at once.
+ *
+ * The rows are collected again for every page, under the same lock as
+ * the page itself, so a compaction between two pages cannot leave them
+ * pointing at moved clients.
+ *
+ * @param SortKey One of enClientListSortKey.
+ * @param Filter Text the name or account number must contain, ignoring case, empty for all.
+ * @param Page Page to print, starting at 0, moved to the last page if the list shrank.
+ * @param PageSize Rows per page.
+ * @param Buffer Reused between pages so its memory is kept.
+ * @return Number of pages of the list.
+ */
+size_t PrintClientListPage(short SortKey, const string& Filter, size_t& Page, size_t PageSize, string& Buffer) {
+
+	const char* Line = "\n________________________________________________________________________________________________\n\n";
+	size_t PageCount = 1;
+
+	Buffer.clear();
+
+	{
+		shared_lock <shared_mutex> Lock(ClientsMutex);
+
+		vector <uint32_t> vRows = GetClientListRows(SortKey, Filter);
+		PageCount = max <size_t>(1, (vRows.size() + PageSize - 1) / PageSize);
+		Page = min(Page, PageCount - 1);
+
+		size_t First = Page * PageSize;
+		size_t Last = min(vRows.size(), First + PageSize);
+
+		Buffer += "\n\t\t\t\t\tClient List (" + to_string(vRows.size()) + ") Client(s).";
+		Buffer += Line;
+		AppendTableCell(Buffer, "Accout Number", 15);
+		AppendTableCell(Buffer, "Pin Code", 10);
+		AppendTableCell(Buffer, "Client Name", 40);
+		AppendTableCell(Buffer, "Phone", 12);
+		AppendTableCell(Buffer, "Balance", 12);
+		Buffer += Line;
+
+		for (size_t i = First; i < Last; i++) {
+			stClient& Client = ClientsRepository.vClients[vRows[i]];
+
+			AppendTableCell(Buffer, Client.AccountNumber, 15);
+			AppendTableCell(Buffer, Client.PinCode, 10);
+			AppendTableCell(Buffer, Client.FullName, 40);
+			AppendTableCell(Buffer, Client.PhoneNumber, 12);
+			AppendTableCell(Buffer, FormatMoney(Client.AccountBalance), 12);
+			Buffer += '\n';
+		}
+	}
+
+	Buffer += Line;
+	Buffer += "Page " + to_string(Page + 1) + " of " + to_string(PageCount) + "\n";
+
+	cout.write(Buffer.data(), Buffer.size());
+	cout.flush();
+
+	return PageCount;
+}
+
+/**
+ * @brief Displays the clients one page at a time.
+ *
+ * Each page sorts and filters the list as row numbers, reads only its
+ * own clients and is written to the console in a single write.
+ */
+void ShowClientListScreen() {
+
+	size_t PageSize = DefaultClientListPageSize;
+	short SortKey = enSortByFileOrder;
+	string Filter;
+
+	ReadClientListOptions(PageSize, SortKey, Filter);
+
+	size_t Page = 0;
+	string Buffer;
+
+	while (true) {
+		size_t PageCount = PrintClientListPage(SortKey, Filter, Page, PageSize, Buffer);
+
+		if (PageCount == 1)
+			break;
+
+		char Answer = 'q';
+
+		cout << "[N]ext page, [P]revious page, [Q]uit? ";
+		cin >> Answer;
+		Answer = (char)tolower((unsigned char)Answer);
+
+		if (!cin || Answer == 'q')
+			break;
+
+		if (Answer == 'n' && Page + 1 < PageCount)
+			Page++;
+		else if (Answer == 'p' && Page > 0)
+			Page--;
+
+		system("cls");
+	}
+}
+
+/**
+ * @brief Asks how to find a client.
+ * @return One of enFindClientMode, 0 if the input ended.
+ */
+short ReadFindClientMode() {
+
+	short FindMode = 0;
+
+	cout << "Find by:\n";
+	cout << "\t[1] Account Number.\n";
+	cout << "\t[2] Name starts with.\n";
+	cout << "\t[3] Name contains.\n";
+	cout << "\t[4] Phone Number.\n";
+
+	do {
+		cout << "Choose how to find the client? [1 to 4]? ";
+		cin >> FindMode;
+
+		if (cin.eof())
+			return 0;
+
+		if (cin.fail()) {
+			cin.clear();
+			cin.ignore(numeric_limits<streamsize>::max(), '\n');
+			FindMode = -1;
+		}
+	} while (FindMode < 1 || FindMode > 4);
+
+	return FindMode;
+}
+
+void ShowFindClientScreen() {
+
+	cout << "\n---------------------------------------------------------------\n";
+	cout << "\t\tFind Client Screen\n";
+	cout << "---------------------------------------------------------------\n\n";
+
+	short FindMode = ReadFindClientMode();
+
+	if (FindMode == enFindByAccountNumber) {
+		stClient Client;
+		string AccountNumber = ReadClientAccountNumber();
+
+		if (FindClientByAccountNumber(AccountNumber, Client))
+			PrintClientData(Client);
+		else
+			cout << "\nClient with Account Number (" << AccountNumber << ") is Not Found!\n";
+	}
+	else if (FindMode == enFindByNamePrefix || FindMode == enFindByNameContains) {
+		string Name;
+
+		cout << "\nEnter Name? ";
+		getline(cin >> ws, Name);
+
+		vector <stClient> vClients = FindClientsByName(Name, (FindMode == enFindByNamePrefix) ? enNamePrefix : enNameContains);
+		PrintFoundClients(vClients);
+	}
+	else if (FindMode == enFindByPhoneNumber) {
+		string PhoneNumber;
+
+		cout << "\nEnter Phone Number? ";
+		getline(cin >> ws, PhoneNumber);
+
+		vector <stClient> vClients = FindClientsByPhoneNumber(PhoneNumber);
+		PrintFoundClients(vClients);
+	}
+}
+
+void ShowFindUserScreen() {
+	cout << "\n---------------------------------------------------------------\n";
+	cout << "\t\tFind User Screen\n";
+	cout << "---------------------------------------------------------------\n\n";
+
+	stUser User;
+	string UserName = "";
+
+	cout << "Enter Username? ";
+	cin >> UserName;
+
+	if (FindUserByUserName(UserName, User))
+		PrintUserData(User);
+	else
+		cout << "\nUser with User Name (" << UserName << ") is Not Found!\n";
+
+}
+
+/**
+ * @brief Displays program end screen.
+ */
+void ShowEndScreen() {
+	cout << "\n---------------------------------------------------------------\n";
+	cout << "\t\tProgram Ends\n";
+	cout << "---------------------------------------------------------------\n\n";
+}
+
+/**
+ * @brief Shows deposit screen.
+ */
+void ShowDepositScreen() {
+	cout << "\n---------------------------------------------------------------\n";
+	cout << "\t\tDeposit Screen\n";
+	cout << "---------------------------------------------------------------\n\n";
+
+	DepositAmountByClientNumber();
+}
+
+/**
+ * @brief Shows withdraw screen.
+ */
+void ShowWithdrawScreen() {
+	cout << "\n---------------------------------------------------------------\n";
+	cout << "\t\tWithdraw Screen\n";
+	cout << "---------------------------------------------------------------\n\n";
+
+	WithdrawAmountByClientNumber();
+}
+
+/**
+ * @brief Shows transfer screen.
+ */
+void ShowTransferScreen() {
+	cout << "\n---------------------------------------------------------------\n";
+	cout << "\t\tTransfer Screen\n";
+	cout << "---------------------------------------------------------------\n\n";
+
+	TransferAmountBetweenClients();
+}
+
+/**
+ * @brief Prints history entries as a table.
+ * @param vEntries History entries, oldest first.
+ */
+void PrintHistoryEntries(vector <stHistoryEntry>& vEntries) {
+
+	if (vEntries.empty()) {
+		cout << "\nNo transactions found.\n";
+		return;
+	}
+
+	cout << "\n\t\t\t\t\tTransactions (" << vEntries.size() << ").";
+	cout << "\n_______________________________________________________";
+	cout << "_________________________________________\n" << endl;
+	cout << "| " << left << setw(20) << "Date";
+	cout << "| " << left << setw(10) << "Type";
+	cout << "| " << left << setw(14) << "Amount";
+	cout << "| " << left << setw(14) << "Balance";
+	cout << "| " << left << setw(15) << "Operator";
+	cout << "\n_______________________________________________________";
+	cout << "_________________________________________\n" << endl;
+
+	for (stHistoryEntry& Entry : vEntries) {
+		cout << "| " << left << setw(20) << FormatHistoryTime(Entry.Time);
+		cout << "| " << left << setw(10) << ((Entry.Type == 'D') ? "Deposit" : (Entry.Type == 'W') ? "Withdraw" : "Transfer");
+		cout << "| " << left << setw(14) << FormatMoney(Entry.Amount);
+		cout << "| " << left << setw(14) << FormatMoney(Entry.Balance);
+		cout << "| " << left << setw(15) << Entry.Operator;
+		cout << endl;
+	}
+
+	cout << "\n_______________________________________________________";
+	cout << "_________________________________________\n" << endl;
+}
+
+/**
+ * @brief Reads a date from user, asking again until it is valid.
+ * @param Message Question to show.
+ * @param EndOfDay True for the last second of the day, false for the first.
+ * @return The time, 0 if the input ended.
+ */
+int64_t ReadHistoryDate(const string& Message, bool EndOfDay) {
+
+	string Text;
+	int64_t Time = 0;
+
+	cout << Message;
+	while (cin >> Text && !ParseHistoryDate(Text, EndOfDay, Time))
+		cout << "Invalid date, please enter a date like 2024-01-31? ";
+
+	return Time;
+}
+
+/**
+ * @brief Shows the last transactions or a statement of an account.
+ */
+void ShowAccountHistoryScreen() {
+	cout << "\n---------------------------------------------------------------\n";
+	cout << "\t\tAccount History Screen\n";
+	cout << "---------------------------------------------------------------\n\n";
+
+	string AccountNumber = ReadClientAccountNumber();
+	vector <stHistoryEntry> vEntries;
+
+	cout << "\nShow:\n";
+	cout << "\t[1] Last transactions.\n";
+	cout << "\t[2] Statement for a date range.\n";
+
+	if (ReadNumberInRange("Show?", 1, 2) == 1) {
+		short Count = ReadNumberInRange("How many transactions?", 1, MaxHistoryEntries);
+		vEntries = GetLastHistoryEntries(AccountNumber, Count);
+	}
+	else {
+		int64_t From = ReadHistoryDate("From date (YYYY-MM-DD)? ", false);
+		int64_t To = ReadHistoryDate("To date (YYYY-MM-DD)? ", true);
+		vEntries = GetHistoryStatement(AccountNumber, From, To);
+	}
+
+	PrintHistoryEntries(vEntries);
+}
+
+void ShowAccesDeniedMessage() {
+	cout << "\n---------------------------------------------------------------\n";
+	cout << "Access Denied\n";
+	cout << "You Don't have permissions to do this,\n";
+	cout << "Please Contact your Admin\n";
+	cout << "---------------------------------------------------------------\n\n";
+}
+
+/**
+ * @brief Pauses before going back to main menu.
+ */
+void GoBackToMainMenu() {
+	cout << "\n\nPress any key to back to Main Menu..." << endl;
+	system("pause>0");
+}
+
+/**
+ * @brief Pauses before going back to manage users menu.
+ */
+void GoBackToManageUsersMenu() {
+	cout << "\n\nPress any key to back to Manage Users Menu..." << endl;
+	system("pause>0");
+}
+
+/**
+ * @brief Pauses before going back to transactions menu.
+ */
+void GoBackToTransactionsMenu() {
+	cout << "\n\nPress any key to back to Transactions Menu..." << endl;
+	system("pause>0");
+}
+
+/**
+ * @brief Reads a menu option from user.
+ * @param OptionCount Number of options of the menu.
+ * @return Selected option, -1 if the input is not a number, EndOfInputOption if the input ended.
+ */
+short ReadMenuOption(short OptionCount) {
+	short MenuOption = 0;
+
+	cout << "Choose What do you want to do? [1 to " << OptionCount << "]? ";
+	cin >> MenuOption;
+
+	if (cin.fail()) {
+		if (cin.eof())
+			return EndOfInputOption;
+
+		cin.clear();
+		cin.ignore(numeric_limits<streamsize>::max(), '\n');
+		return -1;
+	}
+
+	return MenuOption;
+}
+
+void ShowMainMenuScreen() {
+	system("cls");
+	cout << "========================================\n";
+	cout << "\t\tMain Menu Screen\n";
+	cout << "========================================\n";
+	cout << "\t[1] Show Client List.\n";
+	cout << "\t[2] Add New Client.\n";
+	cout << "\t[3] Delete Client.\n";
+	cout << "\t[4] Update Client Info.\n";
+	cout << "\t[5] Find Client.\n";
+	cout << "\t[6] Transactions.\n";
+	cout << "\t[7] Manage Users.\n";
+	cout << "\t[8] Logout.\n";
+	cout << "========================================\n" << endl;
+}
+
+void ShowTransactionsMenuScreen() {
+	system("cls");
+	cout << "========================================\n";
+	cout << "\t\Transactions Menu Screen\n";
+	cout << "========================================\n";
+	cout << "\t[1] Deposit.\n";
+	cout << "\t[2] Withdraw.\n";
+	cout << "\t[3] Transfer.\n";
+	cout << "\t[4] Account History.\n";
+	cout << "\t[5] Total Balances.\n";
+	cout << "\t[6] Main Menu.\n";
+	cout << "========================================\n" << endl;
+}
+
+void ShowManageUsersMenuScreen() {
+	system("cls");
+	cout << "========================================\n";
+	cout << "\t\Manage Users Menu Screen\n";
+	cout << "========================================\n";
+	cout << "\t[1] List Users.\n";
+	cout << "\t[2] Add New User.\n";
+	cout << "\t[3] Delete User.\n";
+	cout << "\t[4] Update User.\n";
+	cout << "\t[5] Find User.\n";
+	cout << "\t[6] Main Menu.\n";
+	cout << "========================================\n" << endl;
+}
+
+/**
+ * @brief Checks that the rows of a menu are numbered by their place, so
+ *        Actions[Option - 1] is the row of Option.
+ * @param Actions Rows of the menu.
+ * @return True if row i has option i + 1 for every row, false otherwise.
+ */
+template <size_t Count>
+constexpr bool AreMenuRowsInOrder(const stMenuAction(&Actions)[Count]) {
+
+	for (size_t i = 0; i < Count; i++) {
+		if (Actions[i].Option != (short)(i + 1))
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Gets the menu shown in a session state.
+ *
+ * Each menu lists, for every option, the permission it needs, the
+ * screen to run, the pause to show after it and the state to move to.
+ * Adding an option only means adding a row here.
+ *
+ * @param State Session state, any state except enLoginState and enExitState.
+ * @return The menu.
+ */
+const stMenu& GetMenu(enMenuState State) {
+
+	static constexpr stMenuAction MainMenuActions[] = {
+		{ enShowClientList, pListClients, ShowClientListScreen, GoBackToMainMenu, enMainMenuState },
+		{ enAddNewClient, pAddNewClients, ShowAddNewClientScreen, GoBackToMainMenu, enMainMenuState },
+		{ enDeleteClient, pDeleteClient, ShowDeleteClientScreen, GoBackToMainMenu, enMainMenuState },
+		{ enUpdateClient, pUpdateClient, ShowUpdateClientInfoScreen, GoBackToMainMenu, enMainMenuState },
+		{ enFindClient, pFindClient, ShowFindClientScreen, GoBackToMainMenu, enMainMenuState },
+		{ enTransactions, pTransactions, nullptr, nullptr, enTransactionsMenuState },
+		{ enManageUsers, pManageUsers, nullptr, nullptr, enManageUsersMenuState },
+		{ Logout, pNone, nullptr, nullptr, enLoginState } };
+
+	static constexpr stMenuAction TransactionsMenuActions[] = {
+		{ enDeposit, pTransactions, ShowDepositScreen, nullptr, enTransactionsMenuState },
+		{ enWithdraw, pTransactions, ShowWithdrawScreen, nullptr, enTransactionsMenuState },
+		{ enTransfer, pTransactions, ShowTransferScreen, GoBackToTransactionsMenu, enTransactionsMenuState },
+		{ enAccountHistory, pTransactions, ShowAccountHistoryScreen, GoBackToTransactionsMenu, enTransactionsMenuState },
+		{ enTotalBalances, pTransactions, ShowTotalBalnces, GoBackToTransactionsMenu, enTransactionsMenuState },
+		{ enMainMenuTransactions, pNone, nullptr, nullptr, enMainMenuState } };
+
+	static constexpr stMenuAction ManageUsersMenuActions[] = {
+		{ enShowUsersList, pManageUsers, PrintAllUsersData, GoBackToManageUsersMenu, enManageUsersMenuState },
+		{ enAddNewUser, pManageUsers, ShowAddNewUserScreen, GoBackToManageUsersMenu, enManageUsersMenuState },
+		{ enDeleteUser, pManageUsers, ShowDeleteUserScreen, GoBackToManageUsersMenu, enManageUsersMenuState },
+		{ enUpdateUser, pManageUsers, ShowUpdateUserInfoScreen, GoBackToManageUsersMenu, enManageUsersMenuState },
+		{ enFindUser, pManageUsers, ShowFindUserScreen, GoBackToManageUsersMenu, enManageUsersMenuState },
+		{ enMainMenuUsers, pNone, nullptr, nullptr, enMainMenuState } };
+
+	static constexpr stMenu MainMenu = { ShowMainMenuScreen, MainMenuActions, 8 };
+	static constexpr stMenu TransactionsMenu = { ShowTransactionsMenuScreen, TransactionsMenuActions, 6 };
+	static constexpr stMenu ManageUsersMenu = { ShowManageUsersMenuScreen, ManageUsersMenuActions, 6 };
+
+	static_assert(sizeof(MainMenuActions) / sizeof(stMenuAction) == 8, "Main menu needs one row per option");
+	static_assert(sizeof(TransactionsMenuActions) / sizeof(stMenuAction) == 6, "Transactions menu needs one row per option");
+	static_assert(sizeof(ManageUsersMenuActions) / sizeof(stMenuAction) == 6, "Manage users menu needs one row per option");
+	static_assert(AreMenuRowsInOrder(MainMenuActions), "Main menu rows must follow the option order");
+	static_assert(AreMenuRowsInOrder(TransactionsMenuActions), "Transactions menu rows must follow the option order");
+	static_assert(AreMenuRowsInOrder(ManageUsersMenuActions), "Manage users menu rows must follow the option order");
+
+	switch (State) {
+	case enTransactionsMenuState:
+		return TransactionsMenu;
+	case enManageUsersMenuState:
+		return ManageUsersMenu;
+	default:
+		return MainMenu;
+	}
+}
+
+/**
+ * @brief Runs the chosen option of a menu.
+ * @param Menu The menu.
+ * @param Option Chosen option.
+ * @param State Current session state.
+ * @return The next session state, State itself for an unknown option.
+ */
+enMenuState PerformMenuOption(const stMenu& Menu, short Option, enMenuState State) {
+
+	if (Option < 1 || Option > Menu.OptionCount)
+		return State;
+
+	const stMenuAction& Action = Menu.Actions[Option - 1];
+
+	system("cls");
+
+	if (!CheckAccessPermission(Action.Permission)) {
+		ShowAccesDeniedMessage();
+
+		if (Action.GoBack != nullptr)
+			Action.GoBack();
+		else
+			GoBackToMainMenu();
+
+		return State;
+	}
+
+	if (Action.Screen != nullptr)
+		Action.Screen();
+	if (Action.GoBack != nullptr)
+		Action.GoBack();
+
+	return Action.NextState;
+}
+
+/**
+ * @brief Displays the login screen and authenticates the user.
+ *
+ * This function provides a simple login mechanism that prompts the user
+ * for a username and password and validates the credentials.
+ *
+ * @return True once a user is logged in, false if the input ended.
+ */
+bool Login() {
+
+	bool LoginFaild = false;
+	string UserName, Password;
+
+	do {
+		system("cls");
+		cout << "========================================\n";
+		cout << "\t\Login Screen\n";
+		cout << "========================================\n";
+
+		if (LoginFaild)
+			cout << "Invalid UserName/Password!\n";
+
+		cout << "Enter UserName?: ";
+		cin >> UserName;
+
+		cout << "Enter Password?: ";
+		cin >> Password;
+
+		if (!cin)
+			return false;
+
+		LoginFaild = !LoadUserInfo(UserName, Password);
+
+	} while (LoginFaild);
+
+	return true;
+}
+
+/**
+ * @brief Runs the console session as a loop over menu states.
+ *
+ * Every screen returns to this loop, which then moves to the next
+ * state, so the call stack stays flat however long the session lasts.
+ * The loop ends when the input ends.
+ */
+void RunSession() {
+
+	enMenuState State = enLoginState;
+
+	while (State != enExitState) {
+
+		if (State == enLoginState) {
+			State = Login() ? enMainMenuState : enExitState;
+			continue;
+		}
+
+		const stMenu& Menu = GetMenu(State);
+
+		Menu.ShowScreen();
+		short Option = ReadMenuOption(Menu.OptionCount);
+
+		State = (Option == EndOfInputOption) ? enExitState : PerformMenuOption(Menu, Option, State);
+	}
+}
+
+/**
+ * @brief Turns the result of a store operation into a service response.
+ * @param Result Result of the operation.
+ * @param Payload Fields returned on success, empty for none.
+ * @return "OK" followed by the payload, or "ERR#//#" followed by the reason.
+ */
+string MakeServiceResponse(enStoreResult Result, const string& Payload = "") {
+
+	switch (Result) {
+	case enStoreDone:
+		return Payload.empty() ? "OK" : "OK#//#" + Payload;
+	case enStoreNotFound:
+		return "ERR#//#not found";
+	case enStoreAlreadyExists:
+		return "ERR#//#already exists";
+	case enStoreInsufficientFunds:
+		return "ERR#//#insufficient funds";
+	case enStoreInvalidAmount:
+		return "ERR#//#invalid amount";
+	default:
+		return "ERR#//#not allowed";
+	}
+}
+
+/**
+ * @brief Converts a user into a service response line, without the password.
+ * @param User The user.
+ * @return UserName#//#Permissions.
+ */
+string ConvertUserToServiceLine(const stUser& User) {
+
+	return User.UserName + "#//#" + to_string(User.Permissions);
+}
+
+/**
+ * @brief Serves FIND#//#AccountNumber.
+ */
+string ServeFindClient(string_view Arguments) {
+
+	string AccountNumber(Arguments);
+	shared_lock <shared_mutex> RepositoryLock(ClientsMutex);
+
+	stClient* Client = GetClientByAccountNumber(AccountNumber);
+
+	if (Client == nullptr)
+		return MakeServiceResponse(enStoreNotFound);
+
+	lock_guard <mutex> AccountLock(GetAccountLock(AccountNumber));
+
+	return MakeServiceResponse(enStoreDone, ConvertRecordToLine(*Client, "#//#"));
+}
+
+/**
+ * @brief Builds the answer to a client search.
+ * @param vClients Found clients.
+ * @return OK#//#Count followed by one client line per found client.
+ */
+string MakeFoundClientsResponse(vector <stClient>& vClients) {
+
+	string Response = MakeServiceResponse(enStoreDone, to_string(vClients.size()));
+
+	for (stClient& Client : vClients)
+		Response += "\n" + ConvertRecordToLine(Client, "#//#");
+
+	return Response;
+}
+
+/**
+ * @brief Serves a client name search.
+ * @param Arguments Text to search for.
+ * @param Mode enNamePrefix or enNameContains.
+ * @return OK#//#Count followed by one client line per found client.
+ */
+string ServeFindClientsByName(string_view Arguments, enNameSearchMode Mode) {
+
+	vector <stClient> vClients = FindClientsByName(Arguments, Mode);
+	return MakeFoundClientsResponse(vClients);
+}
+
+/**
+ * @brief Serves NAME#//#Prefix.
+ */
+string ServeFindClientsByNamePrefix(string_view Arguments) {
+
+	return ServeFindClientsByName(Arguments, enNamePrefix);
+}
+
+/**
+ * @brief Serves NAMECONTAINS#//#Text.
+ */
+string ServeFindClientsByNameContains(string_view Arguments) {
+
+	return ServeFindClientsByName(Arguments, enNameContains);
+}
+
+/**
+ * @brief Serves PHONE#//#PhoneNumber.
+ * @return OK#//#Count followed by one client line per found client.
+ */
+string ServeFindClientsByPhoneNumber(string_view Arguments) {
+
+	vector <stClient> vClients = FindClientsByPhoneNumber(Arguments);
+	return MakeFoundClientsResponse(vClients);
+}
+
+/**
+ * @brief Serves ADD#//#AccountNumber#//#PinCode#//#FullName#//#Phone#//#Balance.
+ */
+string ServeAddClient(string_view Arguments) {
+
+	stClient Client;
+
+	if (!ConvertClientsLineDataToRecord(Arguments, Client))
+		return "ERR#//#bad request";
+
+	return MakeServiceResponse(AddClientToStore(Client));
+}
+
+/**
+ * @brief Serves UPDATE#//#AccountNumber#//#PinCode#//#FullName#//#Phone#//#Balance.
+ */
+string ServeUpdateClient(string_view Arguments) {
+
+	stClient Client;
+
+	if (!ConvertClientsLineDataToRecord(Arguments, Client))
+		return "ERR#//#bad request";
+
+	return MakeServiceResponse(UpdateClientInStore(Client));
+}
+
+/**
+ * @brief Serves DELETE#//#AccountNumber.
+ */
+string ServeDeleteClient(string_view Arguments) {
+
+	return MakeServiceResponse(DeleteClientFromStore(string(Arguments)));
+}
+
+/**
+ * @brief Serves a deposit or a withdraw request.
+ * @param Arguments AccountNumber#//#Amount.
+ * @param Type enPostingDeposit or enPostingWithdraw.
+ * @return OK#//#NewBalance, or the error.
+ */
+string ServeTransaction(string_view Arguments, enPostingType Type) {
+
+	string_view Fields[2];
+	Money Amount = 0;
+	Money NewBalance = 0;
+
+	if (SplitLine(Arguments, "#//#", Fields, 2) != 2 || !ParseMoney(Fields[1], Amount))
+		return "ERR#//#bad request";
+
+	enStoreResult Result = (Type == enPostingDeposit)
+		? DepositToClient(string(Fields[0]), Amount, NewBalance)
+		: WithdrawFromClient(string(Fields[0]), Amount, NewBalance);
+
+	return MakeServiceResponse(Result, FormatMoney(NewBalance));
+}
+
+/**
+ * @brief Serves DEPOSIT#//#AccountNumber#//#Amount.
+ */
+string ServeDeposit(string_view Arguments) {
+
+	return ServeTransaction(Arguments, enPostingDeposit);
+}
+
+/**
+ * @brief Serves WITHDRAW#//#AccountNumber#//#Amount.
+ */
+string ServeWithdraw(string_view Arguments) {
+
+	return ServeTransaction(Arguments, enPostingWithdraw);
+}
+
+/**
+ * @brief Serves TRANSFER#//#FromAccountNumber#//#ToAccountNumber#//#Amount.
+ * @return OK#//#FromBalance#//#ToBalance, or the error.
+ */
+string ServeTransfer(string_view Arguments) {
+
+	string_view Fields[3];
+	Money Amount = 0;
+	Money FromBalance = 0, ToBalance = 0;
+
+	if (SplitLine(Arguments, "#//#", Fields, 3) != 3 || !ParseMoney(Fields[2], Amount))
+		return "ERR#//#bad request";
+
+	enStoreResult Result = TransferBetweenClients(string(Fields[0]), string(Fields[1]), Amount, FromBalance, ToBalance);
+
+	return MakeServiceResponse(Result, FormatMoney(FromBalance) + "#//#" + FormatMoney(ToBalance));
+}
+
+/**
+ * @brief Builds the answer to a history query.
+ * @param vEntries History entries.
+ * @return OK#//#Count followed by one history line per entry.
+ */
+string MakeHistoryResponse(vector <stHistoryEntry>& vEntries) {
+
+	string Response = MakeServiceResponse(enStoreDone, to_string(vEntries.size()));
+
+	for (stHistoryEntry& Entry : vEntries)
+		Response += "\n" + ConvertHistoryEntryToLine(Entry, "#//#");
+
+	return Response;
+}
+
+/**
+ * @brief Serves HISTORY#//#AccountNumber#//#Count, the last transactions of an account.
+ */
+string ServeLastHistoryEntries(string_view Arguments) {
+
+	string_view Fields[2];
+	size_t Count = 0;
+
+	if (SplitLine(Arguments, "#//#", Fields, 2) != 2 || !ParseNumberField(Fields[1], Count))
+		return "ERR#//#bad request";
+
+	vector <stHistoryEntry> vEntries = GetLastHistoryEntries(string(Fields[0]), min(Count, (size_t)MaxHistoryEntries));
+	return MakeHistoryResponse(vEntries);
+}
+
+/**
+ * @brief Serves STATEMENT#//#AccountNumber#//#FromDate#//#ToDate, dates as YYYY-MM-DD.
+ */
+string ServeHistoryStatement(string_view Arguments) {
+
+	string_view Fields[3];
+	int64_t From = 0, To = 0;
+
+	if (SplitLine(Arguments, "#//#", Fields, 3) != 3
+		|| !ParseHistoryDate(Fields[1], false, From) || !ParseHistoryDate(Fields[2], true, To))
+		return "ERR#//#bad request";
+
+	vector <stHistoryEntry> vEntries = GetHistoryStatement(string(Fields[0]), From, To);
+	return MakeHistoryResponse(vEntries);
+}
+
+/**
+ * @brief Serves TOTAL and answers OK#//#ClientCount#//#TotalBalances from the running totals.
+ */
+string ServeTotalBalances(string_view) {
+
+	stBalanceSummary Summary = GetRunningTotals();
+
+	return MakeServiceResponse(enStoreDone, to_string(Summary.ClientCount) + "#//#" + FormatMoney(Summary.TotalBalances));
+}
+
+/**
+ * @brief Serves VERIFYTOTAL: recounts the totals with a full scan and answers
+ *        OK#//#ClientCount#//#TotalBalances#//#MinBalance#//#MaxBalance#//#MATCH or MISMATCH.
+ */
+string ServeVerifyTotalBalances(string_view) {
+
+	stBalanceSummary Summary;
+	bool Match = VerifyRunningTotals(Summary);
+
+	return MakeServiceResponse(enStoreDone, to_string(Summary.ClientCount) + "#//#" + FormatMoney(Summary.TotalBalances)
+		+ "#//#" + FormatMoney(Summary.MinBalance) + "#//#" + FormatMoney(Summary.MaxBalance) + (Match ? "#//#MATCH" : "#//#MISMATCH"));
+}
+
+/**
+ * @brief Serves USERS and answers OK#//#Count followed by one UserName#//#Permissions line per user.
+ */
+string ServeListUsers(string_view) {
+
+	lock_guard <mutex> Lock(UsersMutex);
+	ParsePendingUsers();
+
+	vector <stUser>& vUsers = UsersRepository.vUsers;
+	string Response = MakeServiceResponse(enStoreDone, to_string(vUsers.size() - UsersRepository.DeletedUsers));
+
+	for (const stUser& User : vUsers) {
+		if (User.MarkForDelete != true)
+			Response += "\n" + ConvertUserToServiceLine(User);
+	}
+
+	return Response;
+}
+
+/**
+ * @brief Serves FINDUSER#//#UserName.
+ */
+string ServeFindUser(string_view Arguments) {
+
+	stUser User;
+
+	if (!FindUserByUserName(string(Arguments), User))
+		return MakeServiceResponse(enStoreNotFound);
+
+	return MakeServiceResponse(enStoreDone, ConvertUserToServiceLine(User));
+}
+
+/**
+ * @brief Serves ADDUSER#//#UserName#//#Password#//#Permissions.
+ */
+string ServeAddUser(string_view Arguments) {
+
+	stUser User;
+
+	if (!ConvertUsersLineDataToRecord(Arguments, User))
+		return "ERR#//#bad request";
+
+	return MakeServiceResponse(AddUserToStore(User));
+}
+
+/**
+ * @brief Serves UPDATEUSER#//#UserName#//#Password#//#Permissions.
+ */
+string ServeUpdateUser(string_view Arguments) {
+
+	stUser User;
+
+	if (!ConvertUsersLineDataToRecord(Arguments, User))
+		return "ERR#//#bad request";
+
+	return MakeServiceResponse(UpdateUserInStore(User));
+}
+
+/**
+ * @brief Serves DELETEUSER#//#UserName.
+ */
+string ServeDeleteUser(string_view Arguments) {
+
+	return MakeServiceResponse(DeleteUserFromStore(string(Arguments)));
+}
+
+/**
+ * @brief Gets a service command by name.
+ *
+ * Adding a request to the service only means adding a row here.
+ *
+ * @param Name Command name, the first field of the request.
+ * @return The command, or nullptr if there is no such command.
+ */
+const stServiceCommand* GetServiceCommand(string_view Name) {
+
+	static const stServiceCommand ServiceCommands[] = {
+		{ "FIND", pFindClient, ServeFindClient },
+		{ "NAME", pFindClient, ServeFindClientsByNamePrefix },
+		{ "NAMECONTAINS", pFindClient, ServeFindClientsByNameContains },
+		{ "PHONE", pFindClient, ServeFindClientsByPhoneNumber },
+		{ "ADD", pAddNewClients, ServeAddClient },
+		{ "UPDATE", pUpdateClient, ServeUpdateClient },
+		{ "DELETE", pDeleteClient, ServeDeleteClient },
+		{ "DEPOSIT", pTransactions, ServeDeposit },
+		{ "WITHDRAW", pTransactions, ServeWithdraw },
+		{ "TRANSFER", pTransactions, ServeTransfer },
+		{ "HISTORY", pTransactions, ServeLastHistoryEntries },
+		{ "STATEMENT", pTransactions, ServeHistoryStatement },
+		{ "TOTAL", pTransactions, ServeTotalBalances },
+		{ "VERIFYTOTAL", pTransactions, ServeVerifyTotalBalances },
+		{ "USERS", pManageUsers, ServeListUsers },
+		{ "FINDUSER", pManageUsers, ServeFindUser },
+		{ "ADDUSER", pManageUsers, ServeAddUser },
+		{ "UPDATEUSER", pManageUsers, ServeUpdateUser },
+		{ "DELETEUSER", pManageUsers, ServeDeleteUser } };
+
+	for (const stServiceCommand& Command : ServiceCommands) {
+		if (Command.Name == Name)
+			return &Command;
+	}
+
+	return nullptr;
+}
+
+/**
+ * @brief Serves one request of a connection.
+ *
+ * A request is one line: the command name, then its fields, separated
+ * by "#//#". A connection must send AUTH#//#UserName#//#Password first,
+ * every other command then runs with the permissions of that user.
+ *
+ * @param Request Request line, without the line end.
+ * @param Session Session of the connection, logged in by AUTH.
+ * @return Response, without the final line end.
+ */
+string ServeRequest(string_view Request, stSession& Session) {
+
+	size_t NameEnd = Request.find("#//#");
+	string_view Name = Request.substr(0, NameEnd);
+	string_view Arguments = (NameEnd == string_view::npos) ? string_view() : Request.substr(NameEnd + 4);
+
+	if (Name == "AUTH") {
+		string_view Fields[2];
+
+		if (SplitLine(Arguments, "#//#", Fields, 2) != 2)
+			return "ERR#//#bad request";
+
+		Session.LoggedIn = AuthenticateUser(string(Fields[0]), string(Fields[1]), Session.User);
+		Session.Rights = Session.LoggedIn ? GetEffectiveRights(Session.User.Permissions) : pNone;
+		OperatorName = Session.LoggedIn ? Session.User.UserName : "";
+
+		return Session.LoggedIn ? MakeServiceResponse(enStoreDone) : "ERR#//#invalid username/password";
+	}
+
+	const stServiceCommand* Command = GetServiceCommand(Name);
+
+	if (Command == nullptr)
+		return "ERR#//#unknown command";
+
+	if (!Session.LoggedIn)
+		return "ERR#//#login required";
+
+	if (!HasPermission(Session.Rights, Command->Permission))
+		return "ERR#//#access denied";
+
+	return Command->Serve(Arguments);
+}
+
+/**
+ * @brief Closes a socket.
+ * @param Socket The socket.
+ */
+void CloseSocket(SocketHandle Socket) {
+#ifdef _WIN32
+	closesocket(Socket);
+#else
+	close(Socket);
+#endif
+}
+
+/**
+ * @brief Sends the whole text on a socket.
+ * @param Socket The socket.
+ * @param Text Text to send.
+ * @return True if everything was sent, false if the connection is broken.
+ */
+bool SendToSocket(SocketHandle Socket, const string& Text) {
+
+	size_t Sent = 0;
+
+	while (Sent < Text.size()) {
+		int Count = (int)send(Socket, Text.data() + Sent, (int)(Text.size() - Sent), 0);
+
+		if (Count <= 0)
+			return false;
+
+		Sent += Count;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Serves the requests of one connection until it is closed or sends QUIT.
+ * @param Socket Connected socket, closed when the function returns.
+ */
+void ServeConnection(SocketHandle Socket) {
+
+	stSession Session;
+	bool Open = true;
+	string Pending;
+	char Buffer[4096];
+
+	while (Open) {
+		int Received = (int)recv(Socket, Buffer, sizeof(Buffer), 0);
+
+		if (Received <= 0)
+			break;
+
+		Pending.append(Buffer, Received);
+
+		size_t LineStart = 0;
+		size_t LineEnd = 0;
+
+		while (Open && (LineEnd = Pending.find('\n', LineStart)) != string::npos) {
+			string_view Request = TrimLineEnd(string_view(Pending).substr(LineStart, LineEnd - LineStart));
+			LineStart = LineEnd + 1;
+
+			if (Request == "QUIT") {
+				SendToSocket(Socket, "OK\n");
+				Open = false;
+			}
+			else
+				Open = SendToSocket(Socket, ServeRequest(Request, Session) + "\n");
+		}
+
+		Pending.erase(0, LineStart);
+
+		if (Open && Pending.size() > MaxServiceRequestLength) {
+			SendToSocket(Socket, "ERR#//#request too long\n");
+			Open = false;
+		}
+	}
+
+	CloseSocket(Socket);
+}
+
+/**
+ * @brief Removes the socket file left by a previous service run.
+ * @param SocketPath Path of the socket file.
+ * @return True if nothing is left at the path, false if the path holds
+ *         something other than a socket or it cannot be removed.
+ */
+bool RemoveStaleSocket(const string& SocketPath) {
+
+#ifdef _WIN32
+	WIN32_FIND_DATAA FindData;
+	HANDLE FindHandle = FindFirstFileA(SocketPath.c_str(), &FindData);
+
+	if (FindHandle == INVALID_HANDLE_VALUE)
+		return GetLastError() == ERROR_FILE_NOT_FOUND;
+
+	FindClose(FindHandle);
+
+	bool IsSocket = (FindData.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) && FindData.dwReserved0 == IO_REPARSE_TAG_AF_UNIX;
+#else
+	struct stat Status;
+
+	if (lstat(SocketPath.c_str(), &Status) != 0)
+		return errno == ENOENT;
+
+	bool IsSocket = S_ISSOCK(Status.st_mode);
+#endif
+
+	return IsSocket && remove(SocketPath.c_str()) == 0;
+}
+
+/**
+ * @brief Runs the headless service on a local (Unix domain) socket.
+ *
+ * The process keeps the clients in memory and serves every connection
+ * on its own thread. Balance changes lock only their account, so
+ * callers working on different accounts do not wait for each other.
+ *
+ * @param SocketPath Path of the socket file, replaced if a socket is
+ *        already there.
+ * @return False if the socket cannot be opened, otherwise never returns.
+ */
+bool RunService(const string& SocketPath) {
+
+	sockaddr_un Address = {};
+
+	if (SocketPath.empty() || SocketPath.size() >= sizeof(Address.sun_path)) {
+		cerr << "Invalid socket path: " << SocketPath << endl;
+		return false;
+	}
+
+	Address.sun_family = AF_UNIX;
+	memcpy(Address.sun_path, SocketPath.c_str(), SocketPath.size() + 1);
+
+#ifdef _WIN32
+	WSADATA WsaData;
+
+	if (WSAStartup(MAKEWORD(2, 2), &WsaData) != 0) {
+		cerr << "Cannot start Winsock." << endl;
+		return false;
+	}
+#else
+	signal(SIGPIPE, SIG_IGN);
+#endif
+
+	SocketHandle Listener = socket(AF_UNIX, SOCK_STREAM, 0);
+
+	if (Listener == InvalidSocket) {
+		cerr << "Cannot create socket." << endl;
+		return false;
+	}
+
+	if (!RemoveStaleSocket(SocketPath)) {
+		cerr << "Cannot use " << SocketPath << ", it is not a socket or cannot be removed." << endl;
+		CloseSocket(Listener);
+		return false;
+	}
+
+	if (bind(Listener, (sockaddr*)&Address, sizeof(Address)) != 0 || listen(Listener, SOMAXCONN) != 0) {
+		cerr << "Cannot listen on " << SocketPath << endl;
+		CloseSocket(Listener);
+		return false;
+	}
+
+	cout << "Serving on " << SocketPath << endl;
+
+	while (true) {
+		SocketHandle Connection = accept(Listener, nullptr, nullptr);
+
+		if (Connection != InvalidSocket)
+			thread(ServeConnection, Connection).detach();
+	}
+}
+
+/**
+ * @brief Gets the time of the last balance change of an account.
+ *
+ * Reads ClientHistory without GroupCommit.Mutex, so it is only called
+ * while no balance can change, as in the end of day run.
+ *
+ * @param AccountNumber Account number.
+ * @return Seconds since 1970-01-01 UTC, 0 if the account never changed.
+ */
+int64_t GetLastActivityTime(const string& AccountNumber) {
 
-	cout << "\n---------------------------------------------------------------\n";
-	cout << "\t\tUpdate Client Info Screen\n";
-	cout << "---------------------------------------------------------------\n\n";
+	auto It = ClientHistory.Blocks.find(AccountNumber);
 
-	string AccountNumber = ReadClientAccountNumber();
-	vector <stClient> vClients = LoadClientsDataFromFile(ClientFileName);
+	if (It == ClientHistory.Blocks.end() || It->second.empty())
+		return 0;
 
-	UpdateClientByAccountNumber(AccountNumber, vClients);
+	return It->second.back().LastTime;
 }
 
-void ShowUpdateUserInfoScreen() {
-	cout << "\n---------------------------------------------------------------\n";
-	cout << "\t\tUpdate User Info Screen\n";
-	cout << "---------------------------------------------------------------\n\n";
+/**
+ * @brief Computes every end of day report over one range of rows.
+ * @param Begin First row.
+ * @param End Row after the last one.
+ * @param TopCount Number of largest balances to keep.
+ * @param DormantBefore Accounts without a change since this time are dormant.
+ * @param Accumulator Output reports of the range.
+ */
+void AccumulateEndOfDayChunk(size_t Begin, size_t End, size_t TopCount, int64_t DormantBefore, stEodAccumulator& Accumulator) {
 
-	string UserName = "";
+	const stClientsColumns& Columns = ClientsRepository.Columns;
+	auto IsSmaller = [](const pair <Money, uint32_t>& A, const pair <Money, uint32_t>& B) {
+		return A.first > B.first || (A.first == B.first && A.second < B.second);
+	};
 
-	cout << "Enter Username? ";
-	cin >> UserName;
+	Accumulator.Summary = ScanBalanceColumn(Begin, End);
 
-	vector <stUser> vUsers = LoadUsersDataFromFile(UserFileName);
+	for (size_t Row = Begin; Row < End; Row++) {
+		if (Columns.vIsActive[Row] == 0)
+			continue;
 
-	UpdateUserByUsername(UserName, vUsers);
-}
+		Money Balance = Columns.vBalances[Row];
 
-void ShowFindClientScreen() {
+		Accumulator.vBucketTotals[GetBalanceBucket(Balance)] += Balance;
 
-	if (!CheckAccessPermission(pFindClient)) {
-		ShowAccesDeniedMessage();
-		GoBackToMainMenu();
-		return;
+		if (TopCount != 0) {
+			Accumulator.vTopBalances.emplace_back(Balance, (uint32_t)Row);
+			push_heap(Accumulator.vTopBalances.begin(), Accumulator.vTopBalances.end(), IsSmaller);
+
+			if (Accumulator.vTopBalances.size() > TopCount) {
+				pop_heap(Accumulator.vTopBalances.begin(), Accumulator.vTopBalances.end(), IsSmaller);
+				Accumulator.vTopBalances.pop_back();
+			}
+		}
+
+		if (GetLastActivityTime(ClientsRepository.vClients[Row].AccountNumber) < DormantBefore)
+			Accumulator.vDormantRows.push_back((uint32_t)Row);
 	}
+}
 
-	cout << "\n---------------------------------------------------------------\n";
-	cout << "\t\tFind Client Screen\n";
-	cout << "---------------------------------------------------------------\n\n";
+/**
+ * @brief Merges the reports of all ranges, in row order.
+ * @param vAccumulators Reports of every range.
+ * @param TopCount Number of largest balances to keep.
+ * @return The merged reports, largest balances first.
+ */
+stEodAccumulator MergeEndOfDayChunks(vector <stEodAccumulator>& vAccumulators, size_t TopCount) {
 
-	stClient Client;
-	string AccountNumber = ReadClientAccountNumber();
-	vector <stClient> vClients = LoadClientsDataFromFile(ClientFileName);
+	stEodAccumulator Report;
+	stBalanceSummary& Summary = Report.Summary;
 
-	if (FindClientByAccountNumber(AccountNumber, vClients, Client))
-		PrintClientData(Client);
-	else
-		cout << "\nClient with Account Number (" << AccountNumber << ") is Not Found!\n";
+	for (stEodAccumulator& Chunk : vAccumulators) {
+		if (Chunk.Summary.ClientCount != 0) {
+			Summary.MinBalance = (Summary.ClientCount == 0) ? Chunk.Summary.MinBalance : min(Summary.MinBalance, Chunk.Summary.MinBalance);
+			Summary.MaxBalance = (Summary.ClientCount == 0) ? Chunk.Summary.MaxBalance : max(Summary.MaxBalance, Chunk.Summary.MaxBalance);
+		}
 
-}
+		Summary.ClientCount += Chunk.Summary.ClientCount;
+		Summary.TotalBalances += Chunk.Summary.TotalBalances;
 
-void ShowFindUserScreen() {
-	cout << "\n---------------------------------------------------------------\n";
-	cout << "\t\tFind User Screen\n";
-	cout << "---------------------------------------------------------------\n\n";
+		for (int Bucket = 0; Bucket < BalanceBucketCount; Bucket++) {
+			Summary.vBuckets[Bucket] += Chunk.Summary.vBuckets[Bucket];
+			Report.vBucketTotals[Bucket] += Chunk.vBucketTotals[Bucket];
+		}
 
-	stUser User;
-	string UserName = "";
+		Report.vTopBalances.insert(Report.vTopBalances.end(), Chunk.vTopBalances.begin(), Chunk.vTopBalances.end());
+		Report.vDormantRows.insert(Report.vDormantRows.end(), Chunk.vDormantRows.begin(), Chunk.vDormantRows.end());
+	}
 
-	cout << "Enter Username? ";
-	cin >> UserName;
+	sort(Report.vTopBalances.begin(), Report.vTopBalances.end(), [](const pair <Money, uint32_t>& A, const pair <Money, uint32_t>& B) {
+		return A.first > B.first || (A.first == B.first && A.second < B.second);
+	});
 
-	if (FindUserByUserName(UserName, User))
-		PrintUserData(User);
-	else
-		cout << "\nUser with User Name (" << UserName << ") is Not Found!\n";
+	if (Report.vTopBalances.size() > TopCount)
+		Report.vTopBalances.resize(TopCount);
 
+	return Report;
 }
 
 /**
- * @brief Displays program end screen.
+ * @brief Quotes a CSV field if it holds a comma, a quote or a line end.
+ * @param Field Field text.
+ * @return The field, ready to be written to a CSV file.
  */
-void ShowEndScreen() {
-	cout << "\n---------------------------------------------------------------\n";
-	cout << "\t\tProgram Ends\n";
-	cout << "---------------------------------------------------------------\n\n";
-}
+string QuoteCsvField(string_view Field) {
 
-/**
- * @brief Shows deposit screen.
- */
-void ShowDepositScreen() {
-	cout << "\n---------------------------------------------------------------\n";
-	cout << "\t\tDeposit Screen\n";
-	cout << "---------------------------------------------------------------\n\n";
+	if (Field.find_first_of(",\"\r\n") == string_view::npos)
+		return string(Field);
 
-	DepositAmountByClientNumber();
+	string Quoted = "\"";
+
+	for (char C : Field) {
+		if (C == '"')
+			Quoted += '"';
+		Quoted += C;
+	}
+
+	return Quoted + "\"";
 }
 
 /**
- * @brief Shows withdraw screen.
+ * @brief Writes the end of day reports as CSV files and a text summary.
+ * @param Directory Output directory.
+ * @param Report Merged reports.
+ * @param DormantDays Days without a change that make an account dormant.
+ * @return True if every file was written, false otherwise.
  */
-void ShowWithdrawScreen() {
-	cout << "\n---------------------------------------------------------------\n";
-	cout << "\t\tWithdraw Screen\n";
-	cout << "---------------------------------------------------------------\n\n";
+bool SaveEndOfDayReports(const string& Directory, stEodAccumulator& Report, int DormantDays) {
+
+	const stBalanceSummary& Summary = Report.Summary;
+	vector <stClient>& vClients = ClientsRepository.vClients;
+	string Totals, TopBalances, Dormant, Histogram, Text;
+
+	Totals = "Metric,Value\n";
+	Totals += "Clients," + to_string(Summary.ClientCount) + "\n";
+	Totals += "TotalBalances," + FormatMoney(Summary.TotalBalances) + "\n";
+	Totals += "MinBalance," + FormatMoney(Summary.MinBalance) + "\n";
+	Totals += "MaxBalance," + FormatMoney(Summary.MaxBalance) + "\n";
+	Totals += "DormantAccounts," + to_string(Report.vDormantRows.size()) + "\n";
+
+	TopBalances = "Rank,AccountNumber,ClientName,Balance\n";
+	for (size_t i = 0; i < Report.vTopBalances.size(); i++) {
+		stClient& Client = vClients[Report.vTopBalances[i].second];
+		TopBalances += to_string(i + 1) + "," + QuoteCsvField(Client.AccountNumber) + "," + QuoteCsvField(Client.FullName)
+			+ "," + FormatMoney(Client.AccountBalance) + "\n";
+	}
 
-	WithdrawAmountByClientNumber();
-}
+	Dormant = "AccountNumber,ClientName,Balance,LastActivity\n";
+	for (uint32_t Row : Report.vDormantRows) {
+		stClient& Client = vClients[Row];
+		int64_t LastActivity = GetLastActivityTime(Client.AccountNumber);
+		Dormant += QuoteCsvField(Client.AccountNumber) + "," + QuoteCsvField(Client.FullName) + "," + FormatMoney(Client.AccountBalance)
+			+ "," + ((LastActivity == 0) ? "never" : FormatHistoryTime(LastActivity)) + "\n";
+	}
 
-void ShowAccesDeniedMessage() {
-	cout << "\n---------------------------------------------------------------\n";
-	cout << "Access Denied\n";
-	cout << "You Don't have permissions to do this,\n";
-	cout << "Please Contact your Admin\n";
-	cout << "---------------------------------------------------------------\n\n";
-}
+	Histogram = "Bucket,Clients,TotalBalances\n";
+	for (int Bucket = 0; Bucket < BalanceBucketCount; Bucket++)
+		Histogram += QuoteCsvField(GetBalanceBucketLabel(Bucket)) + "," + to_string(Summary.vBuckets[Bucket]) + "," + FormatMoney(Report.vBucketTotals[Bucket]) + "\n";
+
+	Text = "End of Day Report, " + FormatHistoryTime(GetHistoryTime()) + "\n\n";
+	Text += "Clients         : " + to_string(Summary.ClientCount) + "\n";
+	Text += "Total Balances  : " + FormatMoney(Summary.TotalBalances) + "\n";
+	Text += "Min Balance     : " + FormatMoney(Summary.MinBalance) + "\n";
+	Text += "Max Balance     : " + FormatMoney(Summary.MaxBalance) + "\n";
+	Text += "Dormant Accounts: " + to_string(Report.vDormantRows.size()) + " (no change in " + to_string(DormantDays) + " days)\n\n";
+	Text += "Top " + to_string(Report.vTopBalances.size()) + " Balances:\n";
+	for (size_t i = 0; i < Report.vTopBalances.size(); i++) {
+		stClient& Client = vClients[Report.vTopBalances[i].second];
+		Text += "  " + to_string(i + 1) + ". " + Client.AccountNumber + "  " + Client.FullName + "  " + FormatMoney(Client.AccountBalance) + "\n";
+	}
+	Text += "\nBalance Distribution:\n";
+	for (int Bucket = 0; Bucket < BalanceBucketCount; Bucket++)
+		Text += "  " + GetBalanceBucketLabel(Bucket) + ": " + to_string(Summary.vBuckets[Bucket]) + " Client(s), " + FormatMoney(Report.vBucketTotals[Bucket]) + "\n";
 
-/**
- * @brief Pauses and returns to main menu.
- */
-void GoBackToMainMenu() {
-	cout << "\n\nPress any key to back to Main Menu..." << endl;
-	system("pause>0");
-	ShowMainMenuScreen();
-}
+	string Prefix = Directory + "/";
 
-void GoBackToManageUsersMenu() {
-	cout << "\n\nPress any key to back to Manage Users Menu..." << endl;
-	system("pause>0");
-	ShowManageUsersMenuScreen();
+	return ReplaceFileAtomically(Prefix + "totals.csv", Totals)
+		&& ReplaceFileAtomically(Prefix + "top_balances.csv", TopBalances)
+		&& ReplaceFileAtomically(Prefix + "dormant_accounts.csv", Dormant)
+		&& ReplaceFileAtomically(Prefix + "balance_histogram.csv", Histogram)
+		&& ReplaceFileAtomically(Prefix + "eod_report.txt", Text);
 }
 
 /**
- * @brief Pauses and returns to transactions menu.
+ * @brief Runs the end of day reports in one parallel pass over the clients.
+ *
+ * The rows are split into one range per worker. Each worker computes
+ * every report over its range into its own accumulator, so no locks are
+ * taken during the pass, and the accumulators are merged at the end.
+ *
+ * @param Directory Output directory, created if missing.
+ * @param RequestedThreads Number of worker threads, 0 for one per core.
+ * @param TopCount Number of largest balances to report.
+ * @param DormantDays Days without a change that make an account dormant.
+ * @return True if the reports were written, false otherwise.
  */
-void GoBackToTransactionsMenu() {
-	cout << "\n\nPress any key to back to Transactions Menu..." << endl;
-	system("pause>0");
-	ShowTransactionsMenuScreen();
+bool RunEndOfDayReports(const string& Directory, unsigned RequestedThreads, size_t TopCount, int DormantDays) {
+
+	error_code Error;
+	filesystem::create_directories(Directory, Error);
+
+	if (Error) {
+		cerr << "Error: cannot create " << Directory << ".\n";
+		return false;
+	}
+
+	auto Start = chrono::steady_clock::now();
+	size_t Rows = ClientsRepository.Columns.vBalances.size();
+	size_t ChunkCount = max <size_t>(1, min <size_t>(GetWorkerThreadCount(RequestedThreads), Rows));
+	int64_t DormantBefore = GetHistoryTime() - (int64_t)DormantDays * 24 * 60 * 60;
+	vector <stEodAccumulator> vAccumulators(ChunkCount);
+
+	RunInParallel(ChunkCount, [&](size_t Chunk) {
+		AccumulateEndOfDayChunk(Rows * Chunk / ChunkCount, Rows * (Chunk + 1) / ChunkCount, TopCount, DormantBefore, vAccumulators[Chunk]);
+	});
+
+	stEodAccumulator Report = MergeEndOfDayChunks(vAccumulators, TopCount);
+	double PassMilliseconds = chrono::duration <double, milli>(chrono::steady_clock::now() - Start).count();
+
+	if (!SaveEndOfDayReports(Directory, Report, DormantDays)) {
+		cerr << "Error: cannot write the reports to " << Directory << ".\n";
+		return false;
+	}
+
+	cout << "End of day reports of " << Report.Summary.ClientCount << " client(s) written to " << Directory
+		<< ", pass took " << PassMilliseconds << " ms using " << ChunkCount << " thread(s).\n";
+
+	return true;
 }
 
 /**
- * @brief Reads main menu option from user.
- * @return Selected option.
+ * @brief Times an operation and counts the allocations it makes.
+ *
+ * Every call is timed on its own, so the percentiles show the spread
+ * of single operations and not only their mean.
+ *
+ * @param Name Name of the benchmark in the results.
+ * @param Operations Number of calls.
+ * @param ItemsPerOperation Records handled by one call.
+ * @param Operation Operation to run, called with the call index.
+ * @return The timings of every call and the allocations of all of them,
+ *         counted only in builds with BANK_BENCHMARK defined.
  */
-enMainMenuOption ReadMainMenuOption() {
-	short MainMenuOption = 0;
+stBenchResult MeasureBenchmark(const string& Name, size_t Operations, uint64_t ItemsPerOperation, const function <void(size_t)>& Operation) {
 
-	cout << "Choose What do you want to do? [1 to 8]? ";
-	cin >> MainMenuOption;
+	stBenchResult Result;
+	Result.Name = Name;
+	Result.ItemsPerOperation = ItemsPerOperation;
+	Result.vMicroseconds.reserve(Operations);
 
-	return (enMainMenuOption)MainMenuOption;
+	uint64_t AllocationsBefore = AllocationCount;
 
+	for (size_t i = 0; i < Operations; i++) {
+		auto Start = chrono::steady_clock::now();
+		Operation(i);
+		Result.vMicroseconds.push_back(chrono::duration <double, micro>(chrono::steady_clock::now() - Start).count());
+	}
+
+	// The timings vector was reserved up front, so only the operation allocated.
+	Result.Allocations = AllocationCount - AllocationsBefore;
+
+	return Result;
 }
 
 /**
- * @brief Reads transactions menu option from user.
- * @return Selected option.
+ * @brief Prints one benchmark result as a CSV line.
+ * @param Records Number of records of the data set.
+ * @param Result Benchmark result, its timings get sorted.
  */
-enTransactionsMenuOptions ReadTransactionsMenuOption() {
-	short TransactionsMenuOption = 0;
+void PrintBenchResult(size_t Records, stBenchResult& Result) {
+
+	vector <double>& vTimes = Result.vMicroseconds;
+	size_t Operations = vTimes.size();
 
-	cout << "Choose What do you want to do? [1 to 4]? ";
-	cin >> TransactionsMenuOption;
+	if (Operations == 0)
+		return;
 
-	return (enTransactionsMenuOptions)TransactionsMenuOption;
+	sort(vTimes.begin(), vTimes.end());
 
-}
+	double TotalMicroseconds = 0;
+	for (double Time : vTimes)
+		TotalMicroseconds += Time;
 
-enManageUserMenuOptions ReadManageUsersMenuOption() {
-	short ManageUsersMenuOption = 0;
+	auto Percentile = [&](double Rank) { return vTimes[min(Operations - 1, (size_t)(Rank * Operations))]; };
+	double ItemsPerSecond = (TotalMicroseconds > 0) ? (double)Result.ItemsPerOperation * Operations * 1e6 / TotalMicroseconds : 0;
 
-	cout << "Choose What do you want to do? [1 to 6]? ";
-	cin >> ManageUsersMenuOption;
+	cout << Records << "," << Result.Name << "," << Operations << "," << fixed << setprecision(3)
+		<< TotalMicroseconds / 1000 << "," << setprecision(0) << ItemsPerSecond << "," << setprecision(3)
+		<< Percentile(0.50) << "," << Percentile(0.90) << "," << Percentile(0.99) << "," << vTimes.back() << ",";
 
-	return (enManageUserMenuOptions)ManageUsersMenuOption;
+	if (CountAllocations)
+		cout << setprecision(2) << (double)Result.Allocations / Operations;
 
+	cout << defaultfloat << endl;
 }
 
 /**
- * @brief Handles selected option from transactions menu.
- * @param TransactionsMenuOptions The selected option.
+ * @brief Writes synthetic clients and users files of a given size.
+ *
+ * The data is the same on every run, so results of two builds can be
+ * compared. Passwords are written in plain text, as in the files the
+ * project started with.
+ *
+ * @param Records Number of clients and of users.
+ * @return True if both files were written, false otherwise.
  */
-void PerformTransactionsMenuoption(enTransactionsMenuOptions TransactionsMenuOptions) {
-	switch (TransactionsMenuOptions) {
-	case enDeposit: {
-		system("cls");
-		ShowDepositScreen();
-		ShowTransactionsMenuScreen();
-		break;
-	}
-	case enWithdraw: {
-		system("cls");
-		ShowWithdrawScreen();
-		ShowTransactionsMenuScreen();
-		break;
-	}
-	case enTotalBalances: {
-		system("cls");
-		ShowTotalBalnces();
-		GoBackToTransactionsMenu();
-		break;
-	}
-	case enMainMenuTransactions: {
-		system("cls");
-		ShowMainMenuScreen();
-		break;
-	}
+bool GenerateBenchData(size_t Records) {
+
+	mt19937_64 Random(Records);
+	string Clients, Users;
+	Clients.reserve(Records * 64);
+	Users.reserve(Records * 32);
+
+	for (size_t i = 0; i < Records; i++) {
+		string Number = to_string(i);
+
+		Clients += "A" + Number + "#//#" + to_string(1000 + Random() % 9000) + "#//#Client " + Number
+			+ "#//#0" + to_string(500000000 + Random() % 500000000) + "#//#" + FormatMoney((Money)(Random() % 100000000)) + "\n";
+		Users += "User" + Number + "#//#" + to_string(1000 + Random() % 9000) + "#//#" + to_string(Random() % 128) + "\n";
 	}
+
+	return ReplaceFileAtomically(ClientFileName, Clients) && ReplaceFileAtomically(UserFileName, Users);
 }
 
 /**
- * @brief Handles selected option from main menu.
- * @param MainMenuOption The selected option.
+ * @brief Runs every benchmark over one data set.
+ * @param Records Number of records of the data set.
+ * @return True if the data set could be generated, false otherwise.
  */
-void PerformMainMenuOption(enMainMenuOption MainMenuOption) {
-	switch (MainMenuOption) {
-	case enShowClientList: {
-		system("cls");
-		PrintAllClientsData();
-		GoBackToMainMenu();
-		break;
-	}
-	case enAddNewClient: {
-		system("cls");
-		ShowAddNewClientScreen();
-		GoBackToMainMenu();
-		break;
-	}
-	case enDeleteClient: {
-		system("cls");
-		ShowDeleteClientScreen();
-		GoBackToMainMenu();
-		break;
-	}
-	case enUpdateClient: {
-		system("cls");
-		ShowUpdateClientInfoScreen();
-		GoBackToMainMenu();
-		break;
-	}
-	case enFindClient: {
-		system("cls");
-		ShowFindClientScreen();
-		GoBackToMainMenu();
-		break;
-	}
-	case enTransactions: {
-		system("cls");
-		ShowTransactionsMenuScreen();
-		break;
-	}
-	case enManageUsers: {
-		system("cls");
-		ShowManageUsersMenuScreen();
-		break;
-	}
-	case Logout: {
-		Login();
-		break;
-	}
-	}
-}
+bool RunBenchmarksOnDataSet(size_t Records) {
 
-void PerformManageUsersMenuOptions(enManageUserMenuOptions ManageUsersMenuOptions) {
-	switch (ManageUsersMenuOptions) {
-	case enShowUsersList: {
-		system("cls");
-		PrintAllUsersData();
-		GoBackToManageUsersMenu();
-		break;
-	}
-	case enAddNewUser: {
-		system("cls");
-		ShowAddNewUserScreen();
-		GoBackToManageUsersMenu();
-		break;
-	}
-	case enDeleteUser: {
-		system("cls");
-		ShowDeleteUserScreen();
-		GoBackToManageUsersMenu();
-		break;
-	}
-	case enUpdateUser: {
-		system("cls");
-		ShowUpdateUserInfoScreen();
-		GoBackToManageUsersMenu();
-		break;
-	}
-	case enFindUser: {
-		system("cls");
-		ShowFindUserScreen();
-		GoBackToManageUsersMenu();
-		break;
-	}
-	case enMainMenuUsers: {
-		system("cls");
-		ShowMainMenuScreen();
-		break;
-	}
-	}
-}
+	cerr << "Generating " << Records << " record(s)..." << endl;
 
-void ShowMainMenuScreen() {
-	system("cls");
-	cout << "========================================\n";
-	cout << "\t\tMain Menu Screen\n";
-	cout << "========================================\n";
-	cout << "\t[1] Show Client List.\n";
-	cout << "\t[2] Add New Client.\n";
-	cout << "\t[3] Delete Client.\n";
-	cout << "\t[4] Update Client Info.\n";
-	cout << "\t[5] Find Client.\n";
-	cout << "\t[6] Transactions.\n";
-	cout << "\t[7] Manage Users.\n";
-	cout << "\t[8] Logout.\n";
-	cout << "========================================\n" << endl;
+	remove(GetClientJournalFileName().c_str());
+	remove(ClientHistoryFileName.c_str());
+	remove(UserJournalFileName.c_str());
 
-	PerformMainMenuOption(ReadMainMenuOption());
-}
+	if (!GenerateBenchData(Records))
+		return false;
 
-void ShowTransactionsMenuScreen() {
+	vector <stBenchResult> vResults;
+	mt19937_64 Random(Records);
 
-	if (!CheckAccessPermission(pTransactions)) {
-		ShowAccesDeniedMessage();
-		GoBackToMainMenu();
-		return;
+	vResults.push_back(MeasureBenchmark("load_clients", BenchRepetitions, Records, [](size_t) { LoadClientsRepository(); }));
+	vResults.push_back(MeasureBenchmark("load_users", BenchRepetitions, Records, [](size_t) { LoadUsersRepository(); lock_guard <mutex> Lock(UsersMutex); ParsePendingUsers(); }));
+
+	vector <stClient>& vClients = ClientsRepository.vClients;
+	size_t Samples = min(BenchSampleOperations, vClients.size());
+	vector <string> vLines, vAccountNumbers;
+	vector <string_view> vFields(5);
+	stClient Client;
+
+	for (size_t i = 0; i < Samples; i++) {
+		vLines.push_back(ConvertRecordToLine(vClients[i], "#//#"));
+		vAccountNumbers.push_back(vClients[Random() % vClients.size()].AccountNumber);
 	}
 
-	system("cls");
-	cout << "========================================\n";
-	cout << "\t\Transactions Menu Screen\n";
-	cout << "========================================\n";
-	cout << "\t[1] Deposit.\n";
-	cout << "\t[2] Withdraw.\n";
-	cout << "\t[3] Total Balances.\n";
-	cout << "\t[4] Main Menu.\n";
-	cout << "========================================\n" << endl;
+	vResults.push_back(MeasureBenchmark("split_line", Samples, 1, [&](size_t i) { BenchSink += SplitLine(vLines[i], "#//#", vFields.data(), 5); }));
+	vResults.push_back(MeasureBenchmark("parse_client", Samples, 1, [&](size_t i) { BenchSink += ConvertClientsLineDataToRecord(vLines[i], Client); }));
+	vResults.push_back(MeasureBenchmark("find_client", Samples, 1, [&](size_t i) { BenchSink += FindClientByAccountNumber(vAccountNumbers[i], Client); }));
 
-	PerformTransactionsMenuoption(ReadTransactionsMenuOption());
-}
+	// Kept under JournalCompactionThreshold, so no compaction runs in the
+	// middle; the cost of a snapshot is measured by save_clients.
+	size_t BalanceOperations = min(BenchBalanceOperations, Samples);
+	Money NewBalance = 0;
+	OperatorName = "bench";
 
-void ShowManageUsersMenuScreen() {
+	vResults.push_back(MeasureBenchmark("deposit", BalanceOperations, 1, [&](size_t i) { DepositToClient(vAccountNumbers[i], 100, NewBalance); }));
+	vResults.push_back(MeasureBenchmark("withdraw", BalanceOperations, 1, [&](size_t i) { WithdrawFromClient(vAccountNumbers[i], 100, NewBalance); }));
 
-	if (!CheckAccessPermission(pManageUsers)) {
-		ShowAccesDeniedMessage();
-		GoBackToMainMenu();
-		return;
-	}
+	vResults.push_back(MeasureBenchmark("scan_balances", BenchRepetitions, Records, [](size_t) { BenchSink += ScanBalanceColumn(0, ClientsRepository.Columns.vBalances.size()).TotalBalances; }));
+	vResults.push_back(MeasureBenchmark("running_totals", Samples, 1, [](size_t) { BenchSink += GetRunningTotals().TotalBalances; }));
+	vResults.push_back(MeasureBenchmark("save_clients", BenchRepetitions, Records, [](size_t) { SaveClientsRepository(); }));
 
-	system("cls");
-	cout << "========================================\n";
-	cout << "\t\Manage Users Menu Screen\n";
-	cout << "========================================\n";
-	cout << "\t[1] List Users.\n";
-	cout << "\t[2] Add New User.\n";
-	cout << "\t[3] Delete User.\n";
-	cout << "\t[4] Update User.\n";
-	cout << "\t[5] Find User.\n";
-	cout << "\t[6] Main Menu.\n";
-	cout << "========================================\n" << endl;
+	for (stBenchResult& Result : vResults)
+		PrintBenchResult(Records, Result);
 
-	PerformManageUsersMenuOptions(ReadManageUsersMenuOption());
+	return true;
 }
 
 /**
- * @brief Displays the login screen and authenticates the user.
+ * @brief Runs the benchmarks over synthetic data sets of every size.
  *
- * This function provides a simple login mechanism that prompts the user
- * for a username and password, validates the credentials, and grants
- * access to the main menu upon successful authentication.
+ * The data files are generated in Directory, which becomes the working
+ * directory, so the real store is never touched. Results are printed as
+ * CSV, one line per benchmark and data set; progress goes to the error
+ * stream.
+ *
+ * @param Directory Scratch directory, created if missing.
+ * @param vRecordCounts Sizes of the data sets.
+ * @return True if every data set ran, false otherwise.
  */
-void Login() {
+bool RunBenchmarks(const string& Directory, const vector <size_t>& vRecordCounts) {
 
-	bool LoginFaild = false;
-	string UserName, Password;
+	error_code Error;
+	filesystem::create_directories(Directory, Error);
 
-	do {
-		system("cls");
-		cout << "========================================\n";
-		cout << "\t\Login Screen\n";
-		cout << "========================================\n";
+	if (!Error)
+		filesystem::current_path(Directory, Error);
 
-		if (LoginFaild)
-			cout << "Invalid UserName/Password!\n";
+	if (Error) {
+		cerr << "Error: cannot use " << Directory << " for the benchmarks.\n";
+		return false;
+	}
 
-		cout << "Enter UserName?: ";
-		cin >> UserName;
+	cout << "records,benchmark,operations,total_ms,items_per_sec,p50_us,p90_us,p99_us,max_us,allocations_per_op" << endl;
 
-		cout << "Enter Password?: ";
-		cin >> Password;
+	for (size_t Records : vRecordCounts) {
+		if (!RunBenchmarksOnDataSet(Records)) {
+			cerr << "Error: cannot write the data set of " << Records << " record(s).\n";
+			return false;
+		}
+	}
 
-		LoginFaild = !LoadUserInfo(UserName, Password);
+	return true;
+}
 
-	} while (LoginFaild);
+/**
+ * @brief Parses a comma separated list of data set sizes, like "10000,1000000".
+ * @param Text List text.
+ * @param vRecordCounts Output sizes.
+ * @return True if every size is a positive number, false otherwise.
+ */
+bool ParseBenchRecordCounts(string_view Text, vector <size_t>& vRecordCounts) {
+
+	vRecordCounts.clear();
+
+	while (true) {
+		size_t Comma = Text.find(',');
+		size_t Records = 0;
+
+		if (!ParseNumberField(Text.substr(0, Comma), Records) || Records == 0)
+			return false;
+
+		vRecordCounts.push_back(Records);
+
+		if (Comma == string_view::npos)
+			return true;
+
+		Text.remove_prefix(Comma + 1);
+	}
+}
 
-	ShowMainMenuScreen();
+/**
+ * @brief Prints the command line options.
+ */
+void ShowUsage() {
+	cout << "Usage: Bank [option]\n\n";
+	cout << "  --binary           Load and save clients using " << ClientBinaryFileName << ".\n";
+	cout << "  --export-binary    Convert " << ClientFileName << " into " << ClientBinaryFileName << ".\n";
+	cout << "  --import-binary    Convert " << ClientBinaryFileName << " into " << ClientFileName << ".\n";
+	cout << "  --post <file>      Apply a posting file (AccountNumber#//#D or W#//#Amount per line) and exit.\n";
+	cout << "  --threads <n>      Number of worker threads for --post and --eod-report, default one per core.\n";
+	cout << "  --eod-report <dir> Write the end of day reports (totals, top balances, dormant accounts, histogram) to dir and exit.\n";
+	cout << "  --top <n>          Largest balances in the end of day reports, default " << DefaultEodTopCount << ".\n";
+	cout << "  --dormant-days <n> Days without a change that make an account dormant, default " << DefaultEodDormantDays << ".\n";
+	cout << "  --bench <dir>      Run the benchmarks on synthetic data generated in dir, print CSV results and exit.\n";
+	cout << "                     Allocation counts need a build with BANK_BENCHMARK defined.\n";
+	cout << "  --bench-records <n,n,...>  Sizes of the benchmark data sets, default 10000,1000000,10000000.\n";
+	cout << "  --serve <socket>   Serve client, transaction and user requests on a local socket.\n";
+	cout << "  --commit-window <ms>  Longest wait before a journal batch is written, default " << GroupCommitWindowMilliseconds << ".\n";
+	cout << "  --hash-iterations <n>  Rounds of the password hash for new passwords, default " << PasswordHashIterations << ".\n";
+	cout << "  --commit-batch <n>    Journal records written in one batch at most, default " << GroupCommitMaxRecords << ".\n";
 }
 
-int main()
+int main(int argc, char* argv[])
 {
 
-	Login();
-	return 0;
+	string PostingFileName = "";
+	string SocketPath = "";
+	string EodReportDirectory = "";
+	string BenchDirectory = "";
+	vector <size_t> vBenchRecordCounts = DefaultBenchRecordCounts;
+	unsigned WorkerThreads = 0;
+	size_t EodTopCount = DefaultEodTopCount;
+	int EodDormantDays = DefaultEodDormantDays;
+
+	for (int i = 1; i < argc; i++) {
+		string Argument = argv[i];
+
+		if (Argument == "--binary")
+			UseBinarySnapshot = true;
+		else if (Argument == "--export-binary")
+			return ExportClientsToBinaryFile() ? 0 : 1;
+		else if (Argument == "--import-binary")
+			return ImportClientsFromBinaryFile() ? 0 : 1;
+		else if (Argument == "--post" && i + 1 < argc)
+			PostingFileName = argv[++i];
+		else if (Argument == "--serve" && i + 1 < argc)
+			SocketPath = argv[++i];
+		else if (Argument == "--threads" && i + 1 < argc && ParseNumberField(string_view(argv[i + 1]), WorkerThreads) && WorkerThreads != 0)
+			i++;
+		else if (Argument == "--eod-report" && i + 1 < argc)
+			EodReportDirectory = argv[++i];
+		else if (Argument == "--top" && i + 1 < argc && ParseNumberField(string_view(argv[i + 1]), EodTopCount))
+			i++;
+		else if (Argument == "--dormant-days" && i + 1 < argc && ParseNumberField(string_view(argv[i + 1]), EodDormantDays) && EodDormantDays >= 0)
+			i++;
+		else if (Argument == "--bench" && i + 1 < argc)
+			BenchDirectory = argv[++i];
+		else if (Argument == "--bench-records" && i + 1 < argc && ParseBenchRecordCounts(argv[i + 1], vBenchRecordCounts))
+			i++;
+		else if (Argument == "--commit-window" && i + 1 < argc && ParseNumberField(string_view(argv[i + 1]), GroupCommitWindowMilliseconds) && GroupCommitWindowMilliseconds >= 0)
+			i++;
+		else if (Argument == "--hash-iterations" && i + 1 < argc && ParseNumberField(string_view(argv[i + 1]), PasswordHashIterations) && PasswordHashIterations > 0)
+			i++;
+		else if (Argument == "--commit-batch" && i + 1 < argc && ParseNumberField(string_view(argv[i + 1]), GroupCommitMaxRecords) && GroupCommitMaxRecords > 0)
+			i++;
+		else {
+			ShowUsage();
+			return 1;
+		}
+	}
+
+	if (BenchDirectory != "")
+		return RunBenchmarks(BenchDirectory, vBenchRecordCounts) ? 0 : 1;
+
+	if (!LoadClientsRepository()) {
+		cerr << "Error: cannot load the clients from " << (UseBinarySnapshot ? ClientBinaryFileName : ClientFileName) << ".\n";
+		return 1;
+	}
+
+	LoadClientHistory();
+
+	if (!LoadUsersRepository()) {
+		cerr << "Error: cannot load the users from " << UserFileName << ".\n";
+		return 1;
+	}
+
+	bool Succeeded = true;
+
+	if (PostingFileName != "")
+		Succeeded = ProcessPostingFile(PostingFileName, WorkerThreads);
+	else if (EodReportDirectory != "")
+		Succeeded = RunEndOfDayReports(EodReportDirectory, WorkerThreads, EodTopCount, EodDormantDays);
+	else if (SocketPath != "")
+		Succeeded = RunService(SocketPath);
+	else
+		RunSession();
+
+	WaitForGarbageCompactor();
+	FlushGroupCommitAndStop();
+	return Succeeded ? 0 : 1;
 }
\ No newline at end of file